@@ -23,10 +23,28 @@
 #include <apmnkl/operators.hpp>
 #include <apmnkl/pls.hpp>
 
+#include <apmnkl/utils/cache.hpp>
+#include <apmnkl/utils/profile.hpp>
+#include <apmnkl/utils/thread_pool.hpp>
+
 // Standard Includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <random>
+#include <sstream>
+#include <stdexcept>
 #include <tuple>
 
 // Helper IBEA Subcommand CLI Enums
@@ -64,6 +82,35 @@ enum class mutation { um };
  */
 enum class selection { kwt };
 
+// Helper Anytime Data Output Types
+
+/// Format of the anytime data written by a run
+enum class output_format { csv, binary };
+
+/// Layout of the anytime data of a run
+struct output_layout {
+  /// Write the header row
+  bool header = true;
+  /// Prefix every row with the seed of the run (runs of several seeds merged in a single output)
+  bool seed_column = false;
+  /// Format of the rows (csv with delimiter="," or binary trace)
+  output_format format = output_format::csv;
+};
+
+/// Wall-clock time limit of the runs (stopping criterion, along with the maximum evaluations)
+struct time_limit {
+  /// Time limit of a run in seconds (zero for no limit)
+  double seconds = 0;
+  /// Evaluations between two checks of the clock
+  std::size_t check_interval = 1000;
+
+  /// Get the time limit of a run
+  [[nodiscard]] std::chrono::nanoseconds duration() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(seconds));
+  }
+};
+
 // CLI Options
 
 /**
@@ -89,13 +136,15 @@ inline void set_positional_arguments(CLI::App &app, std::string &instance) {
  *
  * @param app CLI::App object that will hold all the global options/flags (below).
  * @param maxeval The maximum number of evaluations performed by the algorithms (stopping criterion)
+ * @param limit The wall-clock time limit of the runs (stopping criterion)
  * @param seed The seed used by the pseudo random number generator used in these algorithms
  * @param output The name of the output file where the standard output stream should be redirected
  * @param ref The reference point considered by hypervolume indicator whilst running the algorithms
  * (anytime measure)
  */
-inline void set_general_options(CLI::App &app, std::size_t &maxeval, unsigned int &seed,
-                                std::string &output, apmnkl::objective_vector &ref) {
+inline void set_general_options(CLI::App &app, std::size_t &maxeval, time_limit &limit,
+                                unsigned int &seed, std::string &output,
+                                apmnkl::objective_vector &ref) {
   app.add_option("-m,--maxeval", maxeval,
                  "= maximum number of evaluations to be performed (stopping criterion).")
       ->needs(app.get_option("instance"))
@@ -103,6 +152,20 @@ inline void set_general_options(CLI::App &app, std::size_t &maxeval, unsigned in
       ->check(CLI::NonNegativeNumber)
       ->group("Options");
 
+  auto time_limit_option =
+      app.add_option("--time-limit", limit.seconds,
+                     "= wall-clock time limit of a run in seconds (stopping criterion, 0 for no\n"
+                     "limit). A run also stops (flushing its anytime data) on SIGTERM/SIGUSR1.")
+          ->needs(app.get_option("instance"))
+          ->check(CLI::NonNegativeNumber)
+          ->group("Options");
+
+  app.add_option("--time-check-interval", limit.check_interval,
+                 "= evaluations between two checks of the time limit.")
+      ->needs(time_limit_option)
+      ->check(CLI::PositiveNumber)
+      ->group("Options");
+
   app.add_option("-s,--seed", seed, "= pseudo random generator seed used by the search heuristics.")
       ->needs(app.get_option("instance"))
       ->check(CLI::NonNegativeNumber)
@@ -121,14 +184,219 @@ inline void set_general_options(CLI::App &app, std::size_t &maxeval, unsigned in
   app.set_help_all_flag("-H,--help-all", "= expand all help.");
 }
 
+/**
+ * @brief Set the CLI anytime data recording options/flags
+ *
+ * @param app CLI::App object that will hold all the anytime options/flags (below).
+ * @param policy The policy followed when recording the anytime data of the algorithms
+ * @param format The format of the anytime data written by the runs
+ */
+inline void set_anytime_options(CLI::App &app, apmnkl::anytime_policy &policy,
+                                output_format &format) {
+  std::map<std::string, apmnkl::anytime_policy::sampling> sampling_opts{
+      {"IMPROVEMENT", apmnkl::anytime_policy::sampling::improvement},
+      {"FIXED_GRID", apmnkl::anytime_policy::sampling::fixed_grid},
+      {"LOG_GRID", apmnkl::anytime_policy::sampling::log_grid}};
+
+  app.add_option("--anytime-sampling", policy.mode,
+                 "= evaluations at which the anytime data is recorded.\n  => (IMPROVEMENT): "
+                 "every improvement of the approximation set.\n  => (FIXED_GRID): every "
+                 "--anytime-step evaluations.\n  => (LOG_GRID): --anytime-step log-spaced "
+                 "evaluations per decade.")
+      ->transform(CLI::CheckedTransformer(sampling_opts, CLI::ignore_case))
+      ->group("Options");
+
+  app.add_option("--anytime-step", policy.step,
+                 "= evaluations between rows (FIXED_GRID) or rows per decade (LOG_GRID).")
+      ->check(CLI::PositiveNumber)
+      ->group("Options");
+
+  app.add_flag("--anytime-deferred", policy.deferred,
+               "= only log the accepted objective vectors during the run and compute the\n"
+               "hypervolume data afterwards.")
+      ->group("Options");
+
+  auto hv_samples_option =
+      app.add_option("--hv-samples", policy.approximation.samples,
+                     "= number of Monte Carlo samples of an approximate hypervolume (0 for "
+                     "the\nexact one), drawn with a fixed seed between the reference point and\n"
+                     "--hv-upper.")
+          ->check(CLI::NonNegativeNumber)
+          ->group("Options");
+
+  app.add_option("--hv-upper", policy.approximation.upper,
+                 "= upper bound of every objective (the box of the Monte Carlo samples, the\n"
+                 "tighter the more precise the estimate).")
+      ->needs(hv_samples_option)
+      ->group("Options");
+
+  std::map<std::string, output_format> format_opts{{"CSV", output_format::csv},
+                                                   {"BINARY", output_format::binary}};
+
+  app.add_option("--output-format", format,
+                 "= format of the anytime data written (streamed while the algorithm runs).\n"
+                 "  => (CSV): csv with delimiter=\",\".\n  => (BINARY): compact binary trace "
+                 "(see apmnkl/utils/sink.hpp).")
+      ->transform(CLI::CheckedTransformer(format_opts, CLI::ignore_case))
+      ->group("Options");
+}
+
+/**
+ * @brief Parse a range of seeds ("a..b", both inclusive, or a single seed "a")
+ *
+ * @param range The range of seeds
+ * @return std::vector<unsigned int> The seeds of the range
+ */
+inline std::vector<unsigned int> parse_seeds(std::string const &range) {
+  auto const sep = range.find("..");
+  std::size_t pos = 0;
+  auto const first = std::stoul(range.substr(0, sep), &pos);
+  if (pos != range.substr(0, sep).size()) {
+    throw std::invalid_argument("invalid seed range");
+  }
+  auto last = first;
+  if (sep != std::string::npos) {
+    last = std::stoul(range.substr(sep + 2), &pos);
+    if (pos != range.size() - sep - 2) {
+      throw std::invalid_argument("invalid seed range");
+    }
+  }
+  if (first > last || last > std::numeric_limits<unsigned int>::max()) {
+    throw std::out_of_range("invalid seed range");
+  }
+
+  std::vector<unsigned int> seeds;
+  for (auto seed = first; seed <= last; ++seed) {
+    seeds.push_back(static_cast<unsigned int>(seed));
+  }
+  return seeds;
+}
+
+/**
+ * @brief Set the CLI multi-seed run options/flags
+ *
+ * @param app CLI::App object that will hold all the multi-seed options/flags (below).
+ * @param seeds The range of seeds ("a..b") of the independent runs of the algorithm
+ * @param jobs The number of runs executed in parallel
+ * @param merge Write the anytime data of every run into a single csv (with a seed column)
+ */
+inline void set_seeds_options(CLI::App &app, std::string &seeds, std::size_t &jobs, bool &merge) {
+  auto seeds_option =
+      app.add_option("--seeds", seeds,
+                     "= range of seeds (a..b) of independent runs of the algorithm, sharing\n"
+                     "the instance (one csv <output>_<seed> per run, unless merged).")
+          ->check(
+              [](std::string const &range) {
+                try {
+                  parse_seeds(range);
+                  return std::string();
+                } catch (std::exception const &) {
+                  return std::string("expected a range of seeds a..b");
+                }
+              },
+              "a..b")
+          ->excludes(app.get_option("--seed"))
+          ->needs(app.get_option("instance"))
+          ->group("Options");
+
+  app.add_option("-j,--jobs", jobs, "= number of runs executed in parallel (0 for one per core).")
+      ->needs(seeds_option)
+      ->check(CLI::NonNegativeNumber)
+      ->group("Options");
+
+  app.add_flag("--merge", merge,
+               "= write the runs into a single csv (to the output file or the standard output)\n"
+               "with a leading seed column.")
+      ->needs(seeds_option)
+      ->group("Options");
+}
+
+/**
+ * @brief Set the CLI checkpoint options/flags
+ *
+ * @param app CLI::App object that will hold all the checkpoint options/flags (below).
+ * @param checkpoint The name of the checkpoint file of the runs
+ */
+inline void set_checkpoint_options(CLI::App &app, std::string &checkpoint) {
+  app.add_option("--checkpoint", checkpoint,
+                 "= checkpoint file of the run (one <checkpoint>_<seed> per run of --seeds).\n"
+                 "A stopped run saves its state into it, and is resumed from it (appending\n"
+                 "to its output) when the command is run again. Completed runs are skipped.")
+      ->needs(app.get_option("--output"))
+      ->excludes(app.get_option("--merge"))
+      ->group("Options");
+}
+
+/**
+ * @brief Set the CLI profiling options/flags
+ *
+ * @param app CLI::App object that will hold all the profiling options/flags (below).
+ * @param profile Write the per-phase breakdown of the run(s) at the end
+ */
+inline void set_profile_options(CLI::App &app, bool &profile) {
+  app.add_flag("--profile", profile,
+               "= write a per-phase breakdown of the run(s) (evaluation, archive, hypervolume,\n"
+               "IBEA fitness assignment and operators) and counters to the standard error\n"
+               "(the library has to be built with APMNKL_PROFILE).")
+      ->needs(app.get_option("instance"))
+      ->group("Options");
+}
+
+/**
+ * @brief Set the CLI evaluation cache options/flags
+ *
+ * @param app CLI::App object that will hold all the evaluation cache options/flags (below).
+ * @param cache The evaluation cache policy of the GSEMO and PLS runs
+ * @param uncounted Do not count the cache hits as evaluations
+ */
+inline void set_cache_options(CLI::App &app, apmnkl::evaluation_cache_policy &cache,
+                              bool &uncounted) {
+  auto cache_option =
+      app.add_option("--eval-cache", cache.slots,
+                     "= number of slots of the cache of the evaluations of GSEMO and PLS (0 for\n"
+                     "no cache). The solutions found in the cache, already offered to the\n"
+                     "archive, are skipped.")
+          ->check(CLI::NonNegativeNumber)
+          ->group("Options");
+
+  app.add_flag("--eval-cache-uncounted", uncounted,
+               "= do not count the cache hits as evaluations (by default the runs are the same\n"
+               "with or without the cache).")
+      ->needs(cache_option)
+      ->group("Options");
+}
+
+/**
+ * @brief Set the GSEMO algorithm options/flags
+ *
+ * @param app CLI::App object that will hold all the GSEMO options/flags (below).
+ * @param islands The number of islands (archives) evolved in parallel
+ * @param migration_interval The evaluations performed by each island between migrations
+ */
+inline void set_gsemo_options(CLI::App &app, std::size_t &islands,
+                              std::size_t &migration_interval) {
+  app.add_option("--islands", islands,
+                 "= number of islands evolving their own archive in parallel\n"
+                 "(0 for one per core). The archives are merged every migration.")
+      ->check(CLI::NonNegativeNumber);
+
+  app.add_option("--migration-interval", migration_interval,
+                 "= evaluations performed by each island between two migrations\n"
+                 "of the merged archive to every island.")
+      ->check(CLI::PositiveNumber);
+}
+
 /**
  * @brief Set the PLS algorithm options/flags
  *
  * @param app CLI::App object that will hold all the PLS options/flags (below).
  * @param pac The PLS algorithm solution acceptance criterion
  * @param pne The PLS algorithm neighboorhood solutions exploration criterion
+ * @param pnh The PLS algorithm neighborhood of the solutions
+ * @param threads The number of threads exploring the neighborhoods of a run
  */
-inline void set_pls_options(CLI::App &app, apmnkl::pls::pac &pac, apmnkl::pls::pne &pne) {
+inline void set_pls_options(CLI::App &app, apmnkl::pls::pac &pac, apmnkl::pls::pne &pne,
+                            apmnkl::pls::pnh &pnh, std::size_t &threads) {
   std::map<std::string, apmnkl::pls::pac> acceptance_opts{
       {"NON_DOMINATING", apmnkl::pls::pac::non_dominating},
       {"DOMINATING", apmnkl::pls::pac::dominating},
@@ -154,6 +422,25 @@ inline void set_pls_options(CLI::App &app, apmnkl::pls::pac &pac, apmnkl::pls::p
          " stop once on neighbor is accepted. \n => (BOTH): use FIRST_IMPROVEMENT until PLS stops,"
          " afterwards use BEST_IMPROVEMENT")
       ->transform(CLI::CheckedTransformer(exploration_opts, CLI::ignore_case));
+
+  std::map<std::string, apmnkl::pls::pnh> neighborhood_opts{
+      {"FLIP", apmnkl::pls::pnh::flip},
+      {"SWAP", apmnkl::pls::pnh::swap},
+      {"FLIP_SWAP", apmnkl::pls::pnh::flip_swap}};
+
+  app.add_option(
+         "-n,--pls-neighborhood", pnh,
+         "= neighborhood of the solutions explored whilst running pls.\n  => (FLIP): flip one "
+         "bit (explored in order).\n  => (SWAP): swap two different bits (explored in a random "
+         "order).\n  => (FLIP_SWAP): flip one bit or swap two different bits (explored in a "
+         "random order).")
+      ->transform(CLI::CheckedTransformer(neighborhood_opts, CLI::ignore_case));
+
+  app.add_option("--threads", threads,
+                 "= number of threads exploring the neighborhoods of the unvisited\n"
+                 "solutions (0 for one per core). With more than one thread the run\n"
+                 "also depends on the scheduling of the threads.")
+      ->check(CLI::NonNegativeNumber);
 }
 
 /**
@@ -165,9 +452,12 @@ inline void set_pls_options(CLI::App &app, apmnkl::pls::pac &pac, apmnkl::pls::p
  * @param scaling_factor The IBEA scaling factor
  * @param adaptive A boolean indicative of the version of the algorithm to be used.
  *                   True for B-IBEA (Basic IBEA) and false for A-IBEA (Adaptive IBEA)
+ * @param threads The number of threads computing the indicator values and fitness of a run
+ * @param parallel_variation Vary the offspring in parallel too (with more than one thread)
  */
 inline void set_ibea_options(CLI::App &app, std::size_t &population_size, std::size_t &generations,
-                             double &scaling_factor, bool &adaptive) {
+                             double &scaling_factor, bool &adaptive, std::size_t &threads,
+                             bool &parallel_variation) {
   app.add_option("-p,--pop-size", population_size, "= max population size.")
       ->required()
       ->check(CLI::NonNegativeNumber);
@@ -181,6 +471,18 @@ inline void set_ibea_options(CLI::App &app, std::size_t &population_size, std::s
       ->check(CLI::NonNegativeNumber);
 
   app.add_flag("-a,--adaptive", adaptive, "= use the adaptive version of the algorithm");
+
+  auto threads_option =
+      app.add_option("--threads", threads,
+                     "= number of threads computing the indicator values and the fitness\n"
+                     "of the population and the evaluations of the offspring (0 for one per\n"
+                     "core).")
+          ->check(CLI::NonNegativeNumber);
+
+  app.add_flag("--parallel-variation", parallel_variation,
+               "= vary the offspring in parallel too, every thread drawing from a stream of\n"
+               "its own. The run then also depends on the number of threads.")
+      ->needs(threads_option);
 }
 
 /**
@@ -241,60 +543,181 @@ inline void set_ibea_selection_options(CLI::App &app, std::size_t &matting_pool_
       ->check(CLI::NonNegativeNumber);
 }
 
-// Write CSV ouput file (Utils)
+/**
+ * @brief Set the batch options object
+ *
+ * @param app CLI::App object that will hold all the batch mode options/flags (below).
+ * @param manifest The name of the manifest file of the jobs.
+ * @param jobs The number of jobs executed in parallel (0 for one per core).
+ */
+inline void set_batch_options(CLI::App &app, std::string &manifest, std::size_t &jobs) {
+  app.add_option("manifest", manifest,
+                 "= manifest of the jobs, one command line of the app per line (its instance,\n"
+                 "options and algorithm, without the program name, e.g. \"i.dat -m 1000 -o\n"
+                 "out.csv PLS\"), where blank lines and lines starting with '#' are ignored.")
+      ->check(CLI::ExistingFile)
+      ->required()
+      ->group("Positionals");
+
+  app.add_option("-j,--jobs", jobs, "= number of jobs executed in parallel (0 for one per core).")
+      ->check(CLI::NonNegativeNumber)
+      ->group("Options");
+}
+
+// Anytime Data Sinks (Utils)
 
 /**
- * @brief Unpack tuple containing the elements of a row and dump
- *        them into the output stream in csv format. (Worker function)
+ * @brief Create the sink streaming the anytime data of a run into a stream
  *
- * @tparam I the index of the current element being printed
- * @tparam Ts The types of the elements contained in the tuple
- * @param os The output stream where the data (in csv format)
- *           should be redirected to
- * @param row  The current row of data
+ * @tparam Row The type for the anytime data rows of the algorithm
+ * @param os The output stream where the data should be written to
+ * @param header The names of the columns (comma separated)
+ * @param layout The layout of the output
+ * @param seed The seed of the run (written if the layout has a seed column)
+ * @return std::shared_ptr<apmnkl::anytime_sink<Row>> The sink of the run
  */
-template <std::size_t I, typename... Ts>
-auto csv_row(std::ostream &os, std::tuple<Ts...> const &row) {
-  if constexpr (I == sizeof...(Ts)) {
-    os << "\n";
-  } else {
-    os << std::setprecision(12) << std::get<I>(row);
-    if constexpr (I + 1 != sizeof...(Ts)) {
-      os << ",";
+template <typename Row>
+std::shared_ptr<apmnkl::anytime_sink<Row>> make_sink(std::ostream &os, std::string const &header,
+                                                     output_layout const &layout,
+                                                     unsigned int const seed) {
+  auto const seed_column = layout.seed_column ? std::optional<unsigned int>(seed) : std::nullopt;
+  if (layout.format == output_format::binary) {
+    return std::make_shared<apmnkl::binary_sink<Row>>(os, header, layout.header, seed_column);
+  }
+  return std::make_shared<apmnkl::csv_sink<Row>>(os, header, layout.header, seed_column);
+}
+
+// Run Reports (Utils)
+
+/**
+ * @brief Report of the runs of a command line (e.g. the runs of --seeds, executed in parallel):
+ *        their messages, each one written at once so the messages of concurrent runs do not
+ *        interleave, and whether one of them was stopped.
+ */
+class run_report {
+ public:
+  /**
+   * @brief Construct a new run_report object
+   *
+   * @param os The output stream where the messages of the runs are written to
+   */
+  explicit run_report(std::ostream &os)
+      : m_os(os) {}
+
+  /// Write a message of a run
+  void write(std::string const &message) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_os << message;
+  }
+
+  /// Record the end of a run, stopped (by its time limit or a stop request) or completed
+  void record(bool const stopped) noexcept {
+    if (stopped) {
+      m_stopped.store(true, std::memory_order_relaxed);
     }
-    csv_row<I + 1>(os, row);
   }
+
+  /// Check if a run was stopped before its maximum number of evaluations
+  [[nodiscard]] bool stopped() const noexcept {
+    return m_stopped.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::ostream &m_os;
+  std::mutex m_mutex;
+  std::atomic<bool> m_stopped{false};
+};
+
+// Checkpoints (Utils)
+
+/// State of the checkpoint file of a run
+enum class checkpoint_state { none, resumable, completed };
+
+/**
+ * @brief Read the state of the checkpoint file of a run. The file holds the size (uint64) of
+ *        the output of the run when the checkpoint was saved, followed by the checkpoint of
+ *        the algorithm (nothing if the run was completed).
+ *
+ * @param checkpoint The name of the checkpoint file
+ * @param output_size The size of the output of the run when the checkpoint was saved
+ * @return checkpoint_state The state of the checkpoint (none if there is no checkpoint file)
+ */
+inline checkpoint_state read_checkpoint_state(std::string const &checkpoint,
+                                              std::uint64_t &output_size) {
+  std::ifstream is(checkpoint, std::ios::binary);
+  if (!is) {
+    return checkpoint_state::none;
+  }
+  is.read(reinterpret_cast<char *>(&output_size), sizeof(output_size));
+  if (!is) {
+    throw std::runtime_error("truncated checkpoint " + checkpoint);
+  }
+  return is.peek() == std::ifstream::traits_type::eof() ? checkpoint_state::completed
+                                                        : checkpoint_state::resumable;
 }
 
 /**
- * @brief Unpack tuple containing the elements of a row and dump
- *        them into the output stream in csv format. (Wrapper function)
+ * @brief Run an algorithm, resuming the run saved in its checkpoint file (if any). The state
+ *        of a stopped run (time limit or stop request) is then saved into the checkpoint
+ *        file, otherwise the file records that the run was completed. The file is written
+ *        next to the checkpoint and renamed, so a job killed meanwhile keeps the previous one.
  *
- * @tparam Ts The types of the elements contained in the tuple
- * @param os The output stream where the data (in csv format)
- *           should be redirected to
- * @param row  The current row of data
+ * @tparam A The type for the algorithm
+ * @tparam F The type for the callback running the algorithm
+ * @tparam Ops The types for the operators of the algorithm with a state
+ * @param algorithm The algorithm
+ * @param checkpoint The name of the checkpoint file (empty to run without checkpoints)
+ * @param os The output stream where the anytime data of the run is written to
+ * @param run The callback running the algorithm
+ * @param operators The operators of the algorithm with a state (saved along with it)
+ * @return true If the run was stopped (by its time limit or a stop request) before its
+ *         maximum number of evaluations
  */
-template <typename... Ts>
-auto write_csv_row(std::ostream &os, std::tuple<Ts...> const &row) {
-  csv_row<0>(os, row);
+template <typename A, typename F, typename... Ops>
+bool run_checkpointed(A &algorithm, std::string const &checkpoint, std::ostream &os, F &&run,
+                      Ops &...operators) {
+  if (checkpoint.empty()) {
+    run();
+    return algorithm.stopped();
+  }
+
+  algorithm.set_resumable(true);
+  std::uint64_t output_size = 0;
+  if (read_checkpoint_state(checkpoint, output_size) == checkpoint_state::resumable) {
+    std::ifstream is(checkpoint, std::ios::binary);
+    is.ignore(sizeof(output_size));
+    algorithm.load_checkpoint(is, operators...);
+  }
+  run();
+
+  auto const temporary = checkpoint + ".tmp";
+  std::ofstream of(temporary, std::ios::binary);
+  output_size = static_cast<std::uint64_t>(os.tellp());
+  of.write(reinterpret_cast<char const *>(&output_size), sizeof(output_size));
+  if (algorithm.stopped()) {
+    algorithm.save_checkpoint(of, operators...);
+  }
+  of.close();
+  if (!of) {
+    throw std::runtime_error("could not write the checkpoint " + checkpoint);
+  }
+  std::filesystem::rename(temporary, checkpoint);
+  return algorithm.stopped();
 }
 
 /**
- * @brief Write anytime data gathered by the search heuristics and
- *        dump them into a stream in the csv format with delimiter=","
+ * @brief Write the number of cache hits of a run to its report (if it used a cache)
  *
- * @tparam R The type of for the container having the row data
- * @param os The output stream where the data (in csv format)
- *           should be redirected to
- * @param header The header row of the csv
- * @param data The payload (rows) with the anytime data
+ * @param report The report of the run
+ * @param cache The evaluation cache policy of the run
+ * @param seed The seed of the run
+ * @param hits The number of cache hits of the run
  */
-template <typename R>
-void to_csv(std::ostream &os, std::string const &header, std::vector<R> const &data) {
-  os << header << '\n';
-  for (auto &row : data) {
-    write_csv_row(os, row);
+inline void report_cache_hits(run_report &report, apmnkl::evaluation_cache_policy const &cache,
+                              unsigned int const seed, std::size_t const hits) {
+  if (cache.slots != 0) {
+    report.write("Cache Hits (seed " + std::to_string(seed) + "): " + std::to_string(hits) +
+                 "\n");
   }
 }
 
@@ -303,60 +726,112 @@ void to_csv(std::ostream &os, std::string const &header, std::vector<R> const &d
 /**
  * @brief CLI::App callback for the gsemo algorithm
  *
- * @param instance The path for the "rmnk" instance (.dat) file to be used.
- *        These files can be generated using the rmnkGenerator.R script
+ * @param evaluator The (shared, read-only) evaluator of the "rmnk" instance to be used
  * @param maxeval The maximum number of evaluations performed by the algorithms (stopping criterion)
+ * @param limit The wall-clock time limit of the run (stopping criterion)
  * @param seed The seed used by the pseudo random number generator used in these algorithms
+ * @param islands The number of islands (archives) evolved in parallel
+ * @param migration_interval The evaluations performed by each island between migrations
  * @param os The name of the output file where the standard output stream should be redirected
+ * @param layout The layout of the anytime data written to the output stream
+ * @param checkpoint The name of the checkpoint file of the run (empty for no checkpoints)
  * @param ref The reference point considered by hypervolume indicator whilst running the algorithms
  * (anytime measure)
+ * @param policy The policy followed when recording the anytime data
+ * @param cache The evaluation cache policy of the run
+ * @param report The report of the run (its messages, and whether it was stopped)
  */
-inline void gsemo(std::string const &instance, std::size_t const maxeval, unsigned int const seed,
-                  std::ostream &os, apmnkl::objective_vector &ref) {
+inline void gsemo(std::shared_ptr<apmnkl::priv::RMNKEval const> const &evaluator,
+                  std::size_t const maxeval, time_limit const &limit, unsigned int const seed,
+                  std::size_t const islands, std::size_t const migration_interval,
+                  std::ostream &os, output_layout const &layout, std::string const &checkpoint,
+                  apmnkl::objective_vector const &ref, apmnkl::anytime_policy const &policy,
+                  apmnkl::evaluation_cache_policy const &cache, run_report &report) {
   if (ref.empty()) {
-    apmnkl::gsemo gsemo(instance, seed);
-    gsemo.run(maxeval);
-    to_csv(os, "evaluation,hypervolume", gsemo.anytime());
+    apmnkl::gsemo gsemo(evaluator, seed);
+    gsemo.set_anytime_policy(policy);
+    gsemo.set_anytime_sink(
+        make_sink<apmnkl::gsemo::anytime_row_type>(os, "evaluation,hypervolume,elapsed_ns",
+                                                    layout, seed));
+    gsemo.set_time_limit(limit.duration(), limit.check_interval);
+    gsemo.set_islands(islands, migration_interval);
+    gsemo.set_evaluation_cache(cache);
+    report.record(run_checkpointed(gsemo, checkpoint, os, [&]() { gsemo.run(maxeval); }));
+    report_cache_hits(report, cache, seed, gsemo.cache_hits());
   } else {
-    apmnkl::gsemo gsemo(instance, seed, ref);
-    gsemo.run(maxeval);
-    to_csv(os, "evaluation,hypervolume", gsemo.anytime());
+    apmnkl::gsemo gsemo(evaluator, seed, ref);
+    gsemo.set_anytime_policy(policy);
+    gsemo.set_anytime_sink(
+        make_sink<apmnkl::gsemo::anytime_row_type>(os, "evaluation,hypervolume,elapsed_ns",
+                                                    layout, seed));
+    gsemo.set_time_limit(limit.duration(), limit.check_interval);
+    gsemo.set_islands(islands, migration_interval);
+    gsemo.set_evaluation_cache(cache);
+    report.record(run_checkpointed(gsemo, checkpoint, os, [&]() { gsemo.run(maxeval); }));
+    report_cache_hits(report, cache, seed, gsemo.cache_hits());
   }
 }
 
 /**
  * @brief CLI::App callback for the pls algorithm
  *
- * @param instance The path for the "rmnk" instance (.dat) file to be used.
- *        These files can be generated using the rmnkGenerator.R script
+ * @param evaluator The (shared, read-only) evaluator of the "rmnk" instance to be used
  * @param maxeval The maximum number of evaluations performed by the algorithms (stopping criterion)
+ * @param limit The wall-clock time limit of the run (stopping criterion)
  * @param seed The seed used by the pseudo random number generator used in these algorithms
  * @param pac The PLS algorithm solution acceptance criterion
  * @param pne The PLS algorithm neighboorhood solutions exploration criterion
+ * @param pnh The PLS algorithm neighborhood of the solutions
+ * @param threads The number of threads exploring the neighborhoods of the run
  * @param os The name of the output file where the standard output stream should be redirected
+ * @param layout The layout of the anytime data written to the output stream
+ * @param checkpoint The name of the checkpoint file of the run (empty for no checkpoints)
  * @param ref The reference point considered by hypervolume indicator whilst running the algorithms
  * (anytime measure)
+ * @param policy The policy followed when recording the anytime data
+ * @param cache The evaluation cache policy of the run
+ * @param report The report of the run (its messages, and whether it was stopped)
  */
-inline void pls(std::string const &instance, std::size_t maxeval, unsigned int seed,
-                apmnkl::pls::pac const pac, apmnkl::pls::pne const pne, std::ostream &os,
-                apmnkl::objective_vector &ref) {
+inline void pls(std::shared_ptr<apmnkl::priv::RMNKEval const> const &evaluator,
+                std::size_t maxeval, time_limit const &limit, unsigned int seed,
+                apmnkl::pls::pac const pac, apmnkl::pls::pne const pne,
+                apmnkl::pls::pnh const pnh, std::size_t const threads, std::ostream &os,
+                output_layout const &layout, std::string const &checkpoint,
+                apmnkl::objective_vector const &ref, apmnkl::anytime_policy const &policy,
+                apmnkl::evaluation_cache_policy const &cache, run_report &report) {
   if (ref.empty()) {
-    apmnkl::pls pls(instance, seed);
-    pls.run(maxeval, pac, pne);
-    to_csv(os, "evaluation,hypervolume", pls.anytime());
+    apmnkl::pls pls(evaluator, seed);
+    pls.set_anytime_policy(policy);
+    pls.set_anytime_sink(
+        make_sink<apmnkl::pls::anytime_row_type>(os, "evaluation,hypervolume,elapsed_ns",
+                                                    layout, seed));
+    pls.set_time_limit(limit.duration(), limit.check_interval);
+    pls.set_threads(threads);
+    pls.set_neighborhood(pnh);
+    pls.set_evaluation_cache(cache);
+    report.record(run_checkpointed(pls, checkpoint, os, [&]() { pls.run(maxeval, pac, pne); }));
+    report_cache_hits(report, cache, seed, pls.cache_hits());
   } else {
-    apmnkl::pls pls(instance, seed, ref);
-    pls.run(maxeval, pac, pne);
-    to_csv(os, "evaluation,hypervolume", pls.anytime());
+    apmnkl::pls pls(evaluator, seed, ref);
+    pls.set_anytime_policy(policy);
+    pls.set_anytime_sink(
+        make_sink<apmnkl::pls::anytime_row_type>(os, "evaluation,hypervolume,elapsed_ns",
+                                                    layout, seed));
+    pls.set_time_limit(limit.duration(), limit.check_interval);
+    pls.set_threads(threads);
+    pls.set_neighborhood(pnh);
+    pls.set_evaluation_cache(cache);
+    report.record(run_checkpointed(pls, checkpoint, os, [&]() { pls.run(maxeval, pac, pne); }));
+    report_cache_hits(report, cache, seed, pls.cache_hits());
   }
 }
 
 /**
  * @brief CLI::App callback for the ibea algorithm
  *
- * @param instance The path for the "rmnk" instance (.dat) file to be used.
- *        These files can be generated using the rmnkGenerator.R script
+ * @param evaluator The (shared, read-only) evaluator of the "rmnk" instance to be used
  * @param maxeval The maximum number of evaluations performed by the algorithms (stopping criterion)
+ * @param limit The wall-clock time limit of the run (stopping criterion)
  * @param seed The seed used by the pseudo random number generator used in these algorithms
  * @param ps The maximum population size
  * @param gen The maximum number of generations
@@ -372,38 +847,72 @@ inline void pls(std::string const &instance, std::size_t maxeval, unsigned int s
  * @param selection The selection method considered by the IBEA selection operator
  * @param adaptive boolean indicative of version of IBEA to be used.
  *                   If true use adaptive version of (A-IBEA) else use (B-IBEA)
+ * @param threads The number of threads computing the indicator values and fitness of the run
+ * @param parallel_variation Vary the offspring in parallel too (with more than one thread)
  * @param os The name of the output file where the standard output stream should be redirected
+ * @param layout The layout of the anytime data written to the output stream
+ * @param checkpoint The name of the checkpoint file of the run (empty for no checkpoints)
  * @param ref The reference point considered by hypervolume indicator whilst running the algorithms
  * (anytime measure)
+ * @param policy The policy followed when recording the anytime data
+ * @param report The report of the run (its messages, and whether it was stopped)
  */
-inline void ibea(std::string const &instance, std::size_t const maxeval, unsigned int const seed,
+inline void ibea(std::shared_ptr<apmnkl::priv::RMNKEval const> const &evaluator,
+                 std::size_t const maxeval, time_limit const &limit, unsigned int const seed,
                  std::size_t const ps, std::size_t const gen, double const k, double const mp,
                  double const cp, std::size_t npts, std::size_t const mps, std::size_t const ts,
                  indicator const indicator, crossover const crossover, mutation const mutation,
-                 selection const selection, bool adaptive, std::ostream &os,
-                 apmnkl::objective_vector &ref) {
-  std::random_device dev;
-  std::mt19937 rng(dev());
+                 selection const selection, bool adaptive, std::size_t const threads,
+                 bool const parallel_variation, std::ostream &os, output_layout const &layout,
+                 std::string const &checkpoint, apmnkl::objective_vector const &ref,
+                 apmnkl::anytime_policy const &policy, run_report &report) {
+  // the generator of the operators is derived from the seed, so the runs can be reproduced, and
+  // every operator draws from a stream of its own (2^128 draws apart)
+  std::seed_seq sequence{seed};
+  apmnkl::xoshiro256ss rng(sequence);
+  auto stream = [&rng]() {
+    auto const generator = rng;
+    rng.jump();
+    return generator;
+  };
 
 /**
  * @brief Helper define to avoid the use of runtime polymorphism methods to distinguish
  * between selection operators that ibea is going to use during its execution
  */
-#define SELECTION(MAXEVAL, POP, GEN, FACTOR, I, C, M, S, ADAPT)                                    \
-  switch (S) {                                                                                     \
-    case selection::kwt:                                                                           \
-      if (ref.empty()) {                                                                           \
-        apmnkl::ibea ibea(instance, seed);                                                         \
-        ibea.run(MAXEVAL, POP, GEN, FACTOR, I, C, M, apmnkl::selection::kwt(ts, mps, rng), ADAPT); \
-        to_csv(os, "evaluation,generation,hypervolume", ibea.anytime());                           \
-      } else {                                                                                     \
-        apmnkl::ibea ibea(instance, seed, ref);                                                    \
-        ibea.run(MAXEVAL, POP, GEN, FACTOR, I, C, M, apmnkl::selection::kwt(ts, mps, rng), ADAPT); \
-        to_csv(os, "evaluation,generation,hypervolume", ibea.anytime());                           \
-      }                                                                                            \
-      break;                                                                                       \
-    default:                                                                                       \
-      throw("Unknown selection method!");                                                          \
+#define SELECTION(MAXEVAL, POP, GEN, FACTOR, I, C, M, S, ADAPT)                           \
+  switch (S) {                                                                            \
+    case selection::kwt: {                                                                \
+      auto crossover_operator = C;                                                        \
+      auto mutation_operator = M;                                                         \
+      auto selection_operator = apmnkl::selection::kwt<apmnkl::xoshiro256ss>(ts, mps,     \
+                                                                             stream());   \
+      auto run = [&](apmnkl::ibea &ibea) {                                                \
+        ibea.set_anytime_policy(policy);                                                  \
+        ibea.set_anytime_sink(make_sink<apmnkl::ibea::anytime_row_type>(                  \
+            os, "evaluation,generation,hypervolume,elapsed_ns", layout, seed));           \
+        ibea.set_time_limit(limit.duration(), limit.check_interval);                      \
+        ibea.set_threads(threads);                                                        \
+        ibea.set_parallel_variation(parallel_variation);                                  \
+        report.record(run_checkpointed(                                                   \
+            ibea, checkpoint, os,                                                         \
+            [&]() {                                                                       \
+              ibea.run(MAXEVAL, POP, GEN, FACTOR, I, crossover_operator, mutation_operator, \
+                       selection_operator, ADAPT);                                        \
+            },                                                                            \
+            crossover_operator, mutation_operator, selection_operator));                  \
+      };                                                                                  \
+      if (ref.empty()) {                                                                  \
+        apmnkl::ibea ibea(evaluator, seed);                                               \
+        run(ibea);                                                                        \
+      } else {                                                                            \
+        apmnkl::ibea ibea(evaluator, seed, ref);                                          \
+        run(ibea);                                                                        \
+      }                                                                                   \
+      break;                                                                              \
+    }                                                                                     \
+    default:                                                                              \
+      throw("Unknown selection method!");                                                 \
   }
 
 /**
@@ -411,13 +920,14 @@ inline void ibea(std::string const &instance, std::size_t const maxeval, unsigne
  * between crossover operators that ibea is going to use during its execution
  *
  */
-#define MUTATION(MAXEVAL, POP, GEN, FACTOR, I, C, M, S, ADAPT)                            \
-  switch (M) {                                                                            \
-    case mutation::um:                                                                    \
-      SELECTION(MAXEVAL, POP, GEN, FACTOR, I, C, apmnkl::mutation::um(mp, rng), S, ADAPT) \
-      break;                                                                              \
-    default:                                                                              \
-      throw("Unknown mutation operator!\n");                                              \
+#define MUTATION(MAXEVAL, POP, GEN, FACTOR, I, C, M, S, ADAPT)                                   \
+  switch (M) {                                                                                   \
+    case mutation::um:                                                                           \
+      SELECTION(MAXEVAL, POP, GEN, FACTOR, I, C,                                                 \
+                apmnkl::mutation::um<apmnkl::xoshiro256ss>(mp, stream()), S, ADAPT)              \
+      break;                                                                                     \
+    default:                                                                                     \
+      throw("Unknown mutation operator!\n");                                                     \
   }
 
 /**
@@ -425,16 +935,18 @@ inline void ibea(std::string const &instance, std::size_t const maxeval, unsigne
  * between crossover operators that ibea is going to use during its execution.
  *
  */
-#define CROSSOVER(MAXEVAL, POP, GEN, FACTOR, I, C, M, S, ADAPT)                                  \
-  switch (C) {                                                                                   \
-    case crossover::npc:                                                                         \
-      MUTATION(MAXEVAL, POP, GEN, FACTOR, I, apmnkl::crossover::npc(npts, cp, rng), M, S, ADAPT) \
-      break;                                                                                     \
-    case crossover::uc:                                                                          \
-      MUTATION(MAXEVAL, POP, GEN, FACTOR, I, apmnkl::crossover::uc(cp, rng), M, S, ADAPT)        \
-      break;                                                                                     \
-    default:                                                                                     \
-      throw("Unknown crossover operator!\n");                                                    \
+#define CROSSOVER(MAXEVAL, POP, GEN, FACTOR, I, C, M, S, ADAPT)                                   \
+  switch (C) {                                                                                    \
+    case crossover::npc:                                                                          \
+      MUTATION(MAXEVAL, POP, GEN, FACTOR, I,                                                      \
+               apmnkl::crossover::npc<apmnkl::xoshiro256ss>(npts, cp, stream()), M, S, ADAPT)     \
+      break;                                                                                      \
+    case crossover::uc:                                                                           \
+      MUTATION(MAXEVAL, POP, GEN, FACTOR, I,                                                      \
+               apmnkl::crossover::uc<apmnkl::xoshiro256ss>(cp, stream()), M, S, ADAPT)            \
+      break;                                                                                      \
+    default:                                                                                      \
+      throw("Unknown crossover operator!\n");                                                     \
   }
 
 /**\
@@ -461,12 +973,212 @@ inline void ibea(std::string const &instance, std::size_t const maxeval, unsigne
   RUN_IBEA_LOOP(maxeval, ps, gen, k, indicator, crossover, mutation, selection, adaptive);
 }
 
-int main(int argc, char **argv) {
+// Multi-Seed Runs
+
+/**
+ * @brief Get the name of the csv file of the run of a seed, i.e. <output>_<seed>.<extension>
+ *
+ * @param output The name of the output file
+ * @param seed The seed of the run
+ * @return std::string The name of the csv file of the run
+ */
+inline std::string seed_output(std::string const &output, unsigned int const seed) {
+  std::filesystem::path path(output);
+  path.replace_filename(path.stem().string() + "_" + std::to_string(seed) +
+                        path.extension().string());
+  return path.string();
+}
+
+/**
+ * @brief Run the algorithm with a seed, writing its anytime data to a file. Given a checkpoint
+ *        file, a run stopped earlier is resumed (appending its rows to the output, once the
+ *        rows written after its checkpoint was saved are dropped), while a run that was
+ *        completed is skipped.
+ *
+ * @tparam F The type for the callback running the algorithm with a seed.
+ * @param seed The seed of the run
+ * @param output The name of the output file
+ * @param checkpoint The name of the checkpoint file of the run (empty for no checkpoints)
+ * @param report The report of the run
+ * @param run The callback running the algorithm with a seed, writing its anytime data to a
+ *            stream with a given layout (and saving its state into a checkpoint file)
+ */
+template <typename F>
+void run_to_file(unsigned int const seed, std::string const &output,
+                 std::string const &checkpoint, run_report &report, F &&run) {
+  std::uint64_t output_size = 0;
+  auto const state = checkpoint.empty() ? checkpoint_state::none
+                                        : read_checkpoint_state(checkpoint, output_size);
+  if (state == checkpoint_state::completed) {
+    report.write("Run with seed " + std::to_string(seed) + " already completed (" + checkpoint +
+                 ")\n");
+    return;
+  }
+  if (state == checkpoint_state::none) {
+    std::ofstream of(output, std::ios::binary);
+    run(seed, of, output_layout{}, checkpoint);
+    return;
+  }
+
+  std::filesystem::resize_file(output, output_size);
+  std::ofstream of(output, std::ios::binary | std::ios::app);
+  of.seekp(0, std::ios::end);
+  run(seed, of, output_layout{false}, checkpoint);
+}
+
+/**
+ * @brief Run the algorithm once per seed, on a pool of worker threads. Each run owns its
+ *        algorithm object (and pseudo random number generators), so the runs are independent
+ *        of the number of jobs. The anytime data of each run is either written to its own csv
+ *        (<output>_<seed>.<extension>), or merged in the order of the seeds into a single csv
+ *        with a seed column (if requested, or if no output file was given). The runs written to
+ *        their own csv use their own checkpoint file (<checkpoint>_<seed>.<extension>).
+ *
+ * @tparam F The type for the callback running the algorithm with a seed.
+ * @param seeds The seeds of the runs
+ * @param jobs The number of runs executed in parallel (0 for one per core)
+ * @param output The name of the output file (empty for the standard output)
+ * @param merge Write the anytime data of every run into a single csv (with a seed column)
+ * @param checkpoint The name of the checkpoint file (empty for no checkpoints)
+ * @param report The report of the runs
+ * @param run The callback running the algorithm with a seed, writing its anytime data to a
+ *            stream with a given csv layout (and saving its state into a checkpoint file)
+ */
+template <typename F>
+void run_seeds(std::vector<unsigned int> const &seeds, std::size_t const jobs,
+               std::string const &output, bool merge, std::string const &checkpoint,
+               run_report &report, F &&run) {
+  merge = merge || output.empty();
+
+  apmnkl::priv::thread_pool pool(jobs);
+  std::vector<std::future<std::string>> runs;
+  for (std::size_t i = 0; i < seeds.size(); ++i) {
+    runs.push_back(pool.submit([&seeds, &output, &checkpoint, &report, &run, merge, i]() {
+      if (apmnkl::stop_requested()) {
+        return std::string();  // the runs not started yet are skipped once stopped
+      }
+      if (!merge) {
+        run_to_file(seeds[i], seed_output(output, seeds[i]),
+                    checkpoint.empty() ? checkpoint : seed_output(checkpoint, seeds[i]), report,
+                    run);
+        return std::string();
+      }
+      std::ostringstream os;
+      run(seeds[i], os, output_layout{i == 0, true}, std::string());
+      return os.str();
+    }));
+  }
+
+  std::ofstream of;
+  auto buf = merge && !output.empty() ? (of.open(output, std::ios::binary), of.rdbuf())
+                                      : std::cout.rdbuf();
+  std::ostream os(buf);
+  for (auto &result : runs) {
+    os << result.get();
+  }
+}
+
+// Batch Runs
+
+/// Get the canonical form of a path (absolute, without dot, dot-dot or symbolic link elements),
+/// so the paths of the same file compare equal
+inline std::string canonical_path(std::string const &path) {
+  return std::filesystem::weakly_canonical(std::filesystem::absolute(path)).string();
+}
+
+/**
+ * @brief Instances loaded by a process (by canonical path), shared (read-only) by the runs of
+ *        its jobs. An instance is loaded the first time it is requested, and kept loaded until
+ *        the jobs reserved on it are released (or, without reservations, until the end).
+ */
+class instance_cache {
+ public:
+  /**
+   * @brief Get the evaluator of an instance, loaded the first time it is requested.
+   *
+   * @param path The path of the instance file
+   * @return std::shared_ptr<apmnkl::priv::RMNKEval const> The evaluator of the instance
+   */
+  std::shared_ptr<apmnkl::priv::RMNKEval const> get(std::string const &path) {
+    auto const key = canonical_path(path);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto &evaluator = m_instances[key].evaluator;
+    if (!evaluator) {
+      evaluator = std::make_shared<apmnkl::priv::RMNKEval const>(path.c_str());
+    }
+    return evaluator;
+  }
+
+  /// Reserve a job on an instance (without loading it), which keeps it loaded until released
+  void reserve(std::string const &path) {
+    auto const key = canonical_path(path);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_instances[key].jobs;
+  }
+
+  /// Release a job reserved on an instance, unloading the instance after its last job (the
+  /// runs still using it keep it alive)
+  void release(std::string const &path) {
+    auto const key = canonical_path(path);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto const it = m_instances.find(key);
+    if (it != m_instances.end() && --it->second.jobs == 0) {
+      m_instances.erase(it);
+    }
+  }
+
+ private:
+  /// Evaluator of an instance (null until loaded) and number of jobs reserved on it
+  struct entry {
+    std::shared_ptr<apmnkl::priv::RMNKEval const> evaluator;
+    std::size_t jobs = 0;
+  };
+
+  std::mutex m_mutex;
+  std::map<std::string, entry> m_instances;
+};
+
+/// Job of a command line, recorded (instead of run) to schedule the jobs of a manifest
+struct job_plan {
+  std::string instance;
+  /// The output files of the job (one per seed, unless merged)
+  std::vector<std::string> outputs;
+  std::size_t maxeval = 0;
+};
+
+/// Environment of a command line of the app
+struct command_context {
+  /// Instances loaded so far
+  instance_cache &instances;
+  /// Stream of the settings of the run and of the errors of the command line
+  std::ostream &log;
+  /// Report of the runs of the command line (their messages, and whether one was stopped)
+  run_report &report;
+  /// Plan recording the job of the command line instead of running it (if not null)
+  job_plan *plan;
+};
+
+/**
+ * @brief Run a command line of the app: set up its options, parse it and run its algorithm.
+ *        Given a plan, the command line is only parsed and checked, and its job recorded
+ *        into the plan (without running it).
+ *
+ * @tparam P The type for the callback parsing the command line.
+ * @param parse The callback parsing the command line into the app
+ * @param context The instances, the stream of the settings and errors, the report of the
+ *                runs and the plan
+ * @return int The exit code of the command line
+ */
+template <typename P>
+int run_command(P &&parse, command_context const &context) {
+  auto &log = context.log;
+
   // App Global Settings
   CLI::App app(
       "Driver app to test the implementation of some search heuristics and "
       "gather\ndata relevant to the study of their performance from an anytime "
-      "perspective\nin the context of pmnk-landscapes problem.\n",
+      "perspective\nin the context of pmnk-landscapes problem (see \"anytime-pmnk-landscapes "
+      "batch\n--help\" to run the jobs of a manifest in a single process).\n",
       "anytime-pmnk-landscapes");
 
   // Setup a custom formatter for this app
@@ -481,28 +1193,78 @@ int main(int argc, char **argv) {
 
   // General Settings
   std::size_t maxeval;
+  time_limit limit;
   unsigned int seed = std::random_device()();
   std::string outfile;
   apmnkl::objective_vector ref;
-  set_general_options(app, maxeval, seed, outfile, ref);
+  set_general_options(app, maxeval, limit, seed, outfile, ref);
+
+  // Multi-Seed Settings
+  std::string seeds;
+  std::size_t jobs = 1;
+  bool merge = false;
+  set_seeds_options(app, seeds, jobs, merge);
+
+  // Checkpoint Settings
+  std::string checkpoint;
+  set_checkpoint_options(app, checkpoint);
+
+  // Profiling Settings
+  bool profile = false;
+  set_profile_options(app, profile);
+
+  // Anytime Data Settings
+  apmnkl::anytime_policy policy;
+  output_format format = output_format::csv;
+  set_anytime_options(app, policy, format);
+
+  // Evaluation Cache Settings
+  apmnkl::evaluation_cache_policy cache;
+  bool cache_uncounted = false;
+  set_cache_options(app, cache, cache_uncounted);
 
   // App Parse Complete Callback (DEBUG)
   app.parse_complete_callback([&]() {
     // Required
-    std::cerr << "Instance: " << instance << "\n";
-    std::cerr << "Maxeval: " << maxeval << "\n";
-    std::cerr << "Seed: " << seed << "\n";
+    log << "Instance: " << instance << "\n";
+    log << "Maxeval: " << maxeval << "\n";
+    if (!seeds.empty()) {
+      log << "Seeds: " << seeds << " (" << jobs << " jobs)\n";
+    } else {
+      log << "Seed: " << seed << "\n";
+    }
 
     // Optionals
     if (!outfile.empty()) {
-      std::cerr << "Output File:  " << outfile << "\n";
+      log << "Output File:  " << outfile << "\n";
+    }
+    if (format == output_format::binary) {
+      log << "Output Format: binary\n";
+    }
+    if (!checkpoint.empty()) {
+      log << "Checkpoint File: " << checkpoint << "\n";
+    }
+    if (profile) {
+      log << "Profile: enabled\n";
+    }
+    if (policy.approximation.samples != 0) {
+      log << "HV Samples: " << policy.approximation.samples << " (upper bound "
+          << policy.approximation.upper << ")\n";
+    }
+    if (cache.slots != 0) {
+      log << "Evaluation Cache: " << cache.slots << " slots (hits "
+          << (cache_uncounted ? "not counted" : "counted") << " as evaluations)\n";
+    }
+    if (limit.seconds > 0) {
+      log << "Time Limit: " << limit.seconds << "s (checked every " << limit.check_interval
+          << " evaluations)\n";
     }
     if (!ref.empty()) {
-      std::cerr << "HV Reference: (" << ref[0];
+      log << "HV Reference: (" << ref[0];
       for (std::size_t i = 1; i < ref.size(); ++i) {
-        std::cerr << ", " << ref[i];
+        log << ", " << ref[i];
       }
-      std::cerr << ")\n";
+      log << ")\n";
     }
   });
 
@@ -517,8 +1279,17 @@ int main(int argc, char **argv) {
           ->ignore_case()
           ->group("Algorithms");
 
+  // GSEMO Subcommand Options
+  std::size_t gsemo_islands = 1;
+  std::size_t gsemo_migration_interval = 1000;
+  set_gsemo_options(*gsemo_subcommand, gsemo_islands, gsemo_migration_interval);
+
   // GSEMO DEBUG
-  gsemo_subcommand->callback([&]() { std::cerr << "Algorithm: GSEMO\n"; });
+  gsemo_subcommand->callback([&log, &gsemo_islands, &gsemo_migration_interval]() {
+    log << "Algorithm: GSEMO\n";
+    log << "Islands: " << gsemo_islands << "\n";
+    log << "Migration Interval: " << gsemo_migration_interval << "\n";
+  });
 
   // PLS Subcommand
   auto pls_subcommand =
@@ -529,14 +1300,20 @@ int main(int argc, char **argv) {
   // PLS Subcommand Options
   auto pls_acceptance_criterion = apmnkl::pls::pac::non_dominating;
   auto pls_neighborhood_exploration = apmnkl::pls::pne::best_improvement;
-  set_pls_options(*pls_subcommand, pls_acceptance_criterion, pls_neighborhood_exploration);
+  auto pls_neighborhood = apmnkl::pls::pnh::flip;
+  std::size_t pls_threads = 1;
+  set_pls_options(*pls_subcommand, pls_acceptance_criterion, pls_neighborhood_exploration,
+                  pls_neighborhood, pls_threads);
 
   // PLS Callback (DEBUG)
-  pls_subcommand->callback([&pls_acceptance_criterion, &pls_neighborhood_exploration]() {
-    std::cerr << "Algorithm: PLS\n";
-    std::cerr << "Acceptance Criterion: " << static_cast<int>(pls_acceptance_criterion) << "\n";
-    std::cerr << "Neighboorhood Exploration: " << static_cast<int>(pls_neighborhood_exploration)
-              << "\n";
+  pls_subcommand->callback([&log, &pls_acceptance_criterion, &pls_neighborhood_exploration,
+                            &pls_neighborhood, &pls_threads]() {
+    log << "Algorithm: PLS\n";
+    log << "Acceptance Criterion: " << static_cast<int>(pls_acceptance_criterion) << "\n";
+    log << "Neighboorhood Exploration: " << static_cast<int>(pls_neighborhood_exploration)
+        << "\n";
+    log << "Neighborhood: " << static_cast<int>(pls_neighborhood) << "\n";
+    log << "Threads: " << pls_threads << "\n";
   });
 
   // IBEA Subcommand
@@ -556,7 +1333,10 @@ int main(int argc, char **argv) {
   std::size_t gen;
   double factor;
   bool adaptive = false;
-  set_ibea_options(*ibea_subcommand, pop, gen, factor, adaptive);
+  std::size_t ibea_threads = 1;
+  bool ibea_parallel_variation = false;
+  set_ibea_options(*ibea_subcommand, pop, gen, factor, adaptive, ibea_threads,
+                   ibea_parallel_variation);
 
   // IBEA Subcommands
   ibea_subcommand->require_subcommand(4);
@@ -567,7 +1347,7 @@ int main(int argc, char **argv) {
                  ->group("Indicators");
 
   // IHD Callback (DEBUG)
-  ihd->callback([]() { std::cerr << "Indicator: IHD\n"; });
+  ihd->callback([&log]() { log << "Indicator: IHD\n"; });
 
   auto eps = ibea_subcommand->add_subcommand("EPS", "Run using the epsilon (+) indicator")
                  ->ignore_case()
@@ -575,7 +1355,7 @@ int main(int argc, char **argv) {
                  ->group("Indicators");
 
   // EPS(+) Callback (DEBUG)
-  eps->callback([]() { std::cerr << "Indicator: EPS(+)\n"; });
+  eps->callback([&log]() { log << "Indicator: EPS(+)\n"; });
 
   // IBEA Mutation Operators (IBEA Sub-Subcommand)
   auto um =
@@ -590,8 +1370,8 @@ int main(int argc, char **argv) {
 
   // Uniform Mutation Callback (DEBUG)
   um->callback([&]() {
-    std::cerr << "Mutation Operator: UniformMutation\n";
-    std::cerr << "Mutation probability: " << mutation_probability << "\n";
+    log << "Mutation Operator: UniformMutation\n";
+    log << "Mutation probability: " << mutation_probability << "\n";
   });
 
   // IBEA Crossover Operators (IBEA Sub-Subcommand)
@@ -616,15 +1396,15 @@ int main(int argc, char **argv) {
 
   // N-Point Crossover Callback (DEBUG)
   npc->callback([&]() {
-    std::cerr << "Crossover Operator: N-Point Crossover\n";
-    std::cerr << "Crossover Probability: " << crossover_probability << "\n";
-    std::cerr << "Number of Crossover Points: " << npoints << "\n";
+    log << "Crossover Operator: N-Point Crossover\n";
+    log << "Crossover Probability: " << crossover_probability << "\n";
+    log << "Number of Crossover Points: " << npoints << "\n";
   });
 
   // Uniform Crossover Callback (DEBUG)
   uc->callback([&]() {
-    std::cerr << "Crossover Operator: Uniform Crossover\n";
-    std::cerr << "Crossover Probability: " << crossover_probability << "\n";
+    log << "Crossover Operator: Uniform Crossover\n";
+    log << "Crossover Probability: " << crossover_probability << "\n";
   });
 
   // IBEA Selection Operators (IBEA Sub-Subcommand)
@@ -642,44 +1422,296 @@ int main(int argc, char **argv) {
 
   // K-Way Tournament Selection Callback (DEBUG)
   kwt->callback([&]() {
-    std::cerr << "Selection Operator: K-Way Tournament\n";
-    std::cerr << "Matting Pool Size: " << matting_pool_size << "\n";
-    std::cerr << "Tournament Size: " << tournament_size << "\n";
+    log << "Selection Operator: K-Way Tournament\n";
+    log << "Matting Pool Size: " << matting_pool_size << "\n";
+    log << "Tournament Size: " << tournament_size << "\n";
   });
 
   // IBEA Callback (DEBUG)
   ibea_subcommand->callback([&]() {
-    std::cerr << "Algorithm: IBEA\n";
-    std::cerr << "Population Size: " << pop << "\n";
-    std::cerr << "Generations: " << gen << "\n";
-    std::cerr << "Scaling Factor: " << factor << "\n";
-    std::cerr << "Adaptive: " << std::boolalpha << adaptive << "\n";
+    log << "Algorithm: IBEA\n";
+    log << "Population Size: " << pop << "\n";
+    log << "Generations: " << gen << "\n";
+    log << "Scaling Factor: " << factor << "\n";
+    log << "Adaptive: " << std::boolalpha << adaptive << "\n";
+    log << "Threads: " << ibea_threads << "\n";
+    log << "Parallel Variation: " << std::boolalpha << ibea_parallel_variation << "\n";
   });
 
   // Main App
   app.callback([&]() {
-    std::ofstream of;
-    auto buf = !outfile.empty() ? (of.open(outfile), of.rdbuf()) : std::cout.rdbuf();
-    std::ostream os(buf);
-
-    if (app.got_subcommand("GSEMO")) {
-      gsemo(instance, maxeval, seed, os, ref);
-
-    } else if (app.got_subcommand("PLS")) {
-      pls(instance, maxeval, seed, pls_acceptance_criterion, pls_neighborhood_exploration, os, ref);
-
-    } else if (app.got_subcommand("IBEA")) {
-      indicator ind = ibea_subcommand->got_subcommand("IHD") ? indicator::ihd : indicator::eps;
-      mutation mut =
-          ibea_subcommand->got_subcommand("UM") ? mutation::um : static_cast<mutation>(-1);
-      crossover cross = ibea_subcommand->got_subcommand("NPC") ? crossover::npc : crossover::uc;
-      selection sel =
-          ibea_subcommand->got_subcommand("KWT") ? selection::kwt : static_cast<selection>(-1);
-      ibea(instance, maxeval, seed, pop, gen, factor, mutation_probability, crossover_probability,
-           npoints, matting_pool_size, tournament_size, ind, cross, mut, sel, adaptive, os, ref);
+    if (profile && !apmnkl::profile_enabled) {
+      throw CLI::ValidationError("--profile",
+                                 "the library was built without profiling (APMNKL_PROFILE)");
+    }
+    // the reference point defaults to the origin
+    auto const below = [&policy](double const r) { return r < policy.approximation.upper; };
+    if (policy.approximation.samples != 0 &&
+        (ref.empty() ? !below(0) : !std::all_of(ref.begin(), ref.end(), below))) {
+      throw CLI::ValidationError("--hv-samples",
+                                 "the reference point is not below the upper bound (--hv-upper)");
+    }
+
+    cache.count_hits = !cache_uncounted;
+
+    if (context.plan != nullptr) {
+      std::vector<std::string> outputs;
+      if (!seeds.empty() && !merge && !outfile.empty()) {
+        for (auto const run_seed : parse_seeds(seeds)) {
+          outputs.push_back(seed_output(outfile, run_seed));
+        }
+      } else if (!outfile.empty()) {
+        outputs.push_back(outfile);
+      }
+      *context.plan = job_plan{instance, std::move(outputs), maxeval};
+      return;
+    }
+
+    // the runs stop cleanly (flushing their anytime data) if the job is terminated
+    apmnkl::stop_on_signals();
+
+    // the instance is loaded once and shared (read-only) by every run
+    auto const evaluator = context.instances.get(instance);
+
+    auto run = [&](unsigned int const run_seed, std::ostream &os, output_layout layout,
+                   std::string const &run_checkpoint) {
+      layout.format = format;
+      if (app.got_subcommand("GSEMO")) {
+        gsemo(evaluator, maxeval, limit, run_seed, gsemo_islands, gsemo_migration_interval, os,
+              layout, run_checkpoint, ref, policy, cache, context.report);
+
+      } else if (app.got_subcommand("PLS")) {
+        pls(evaluator, maxeval, limit, run_seed, pls_acceptance_criterion,
+            pls_neighborhood_exploration, pls_neighborhood, pls_threads, os, layout,
+            run_checkpoint, ref, policy, cache, context.report);
+
+      } else if (app.got_subcommand("IBEA")) {
+        indicator ind = ibea_subcommand->got_subcommand("IHD") ? indicator::ihd : indicator::eps;
+        mutation mut =
+            ibea_subcommand->got_subcommand("UM") ? mutation::um : static_cast<mutation>(-1);
+        crossover cross = ibea_subcommand->got_subcommand("NPC") ? crossover::npc : crossover::uc;
+        selection sel =
+            ibea_subcommand->got_subcommand("KWT") ? selection::kwt : static_cast<selection>(-1);
+        ibea(evaluator, maxeval, limit, run_seed, pop, gen, factor, mutation_probability,
+             crossover_probability, npoints, matting_pool_size, tournament_size, ind, cross, mut,
+             sel, adaptive, ibea_threads, ibea_parallel_variation, os, layout, run_checkpoint,
+             ref, policy, context.report);
+      }
+    };
+
+    auto const start = std::chrono::steady_clock::now();
+    if (!seeds.empty()) {
+      run_seeds(parse_seeds(seeds), jobs, outfile, merge, checkpoint, context.report, run);
+    } else if (!outfile.empty()) {
+      run_to_file(seed, outfile, checkpoint, context.report, run);
+    } else {
+      std::ostream os(std::cout.rdbuf());
+      run(seed, os, output_layout{}, checkpoint);
+    }
+
+    if (profile) {
+      std::ostringstream os;
+      apmnkl::profile_report(os, std::chrono::steady_clock::now() - start);
+      context.report.write(os.str());
     }
   });
 
-  CLI11_PARSE(app, argc, argv);
+  try {
+    parse(app);
+  } catch (CLI::ParseError const &e) {
+    return app.exit(e, std::cout, log);
+  }
   return EXIT_SUCCESS;
 }
+
+/// Job of a manifest: a command line of the app and its line number
+struct manifest_job {
+  std::size_t line;
+  std::string command;
+};
+
+/// Outcome of a job of a manifest
+enum class job_status { completed, stopped, failed, skipped };
+
+/**
+ * @brief Read the jobs of a manifest, one command line of the app per line (without the program
+ *        name), ignoring the blank lines and the lines starting with '#'.
+ *
+ * @param manifest The name of the manifest file
+ * @return std::vector<manifest_job> The jobs, in the order of the manifest
+ */
+inline std::vector<manifest_job> read_manifest(std::string const &manifest) {
+  std::ifstream is(manifest);
+  if (!is) {
+    throw std::runtime_error("could not read the manifest " + manifest);
+  }
+  std::vector<manifest_job> jobs;
+  std::string command;
+  for (std::size_t line = 1; std::getline(is, command); ++line) {
+    auto const first = command.find_first_not_of(" \t\r");
+    if (first == std::string::npos || command[first] == '#') {
+      continue;
+    }
+    command.erase(command.find_last_not_of(" \t\r") + 1);
+    jobs.push_back(manifest_job{line, command.substr(first)});
+  }
+  return jobs;
+}
+
+/**
+ * @brief Get the estimated cost of a job: its evaluations times the cost of an evaluation of
+ *        its instance, O(M N (K + 1)), read from the header of the instance (not loaded).
+ *
+ * @param instance The path of the instance file of the job
+ * @param maxeval The maximum number of evaluations of the job
+ * @return std::optional<double> The estimated cost of the job (none if the instance header
+ *         could not be read)
+ */
+inline std::optional<double> estimated_cost(std::string const &instance,
+                                            std::size_t const maxeval) {
+  unsigned M = 0;
+  unsigned N = 0;
+  unsigned K = 0;
+  if (!apmnkl::priv::RMNKEval::readParameters(instance.c_str(), M, N, K)) {
+    return std::nullopt;
+  }
+  return static_cast<double>(maxeval) * static_cast<double>(M) * static_cast<double>(N) *
+         (static_cast<double>(K) + 1);
+}
+
+/**
+ * @brief Run the jobs of a manifest in a single process (the batch mode of the app). Every job
+ *        is parsed and checked before any of them runs (without loading the instances). The
+ *        jobs are executed on a pool of worker threads, the most expensive ones first (by
+ *        estimated cost, the jobs of the same cost grouped by instance), each writing its
+ *        anytime data to its own output file. An instance is loaded by the first job running
+ *        on it, shared by its other jobs and unloaded after its last one. The status of each
+ *        job is reported once it ends, along with the messages of its runs (and the settings
+ *        and errors of a failed job). Once the process is terminated, the jobs not started
+ *        yet are skipped, and with checkpoints, running the manifest again resumes the jobs
+ *        stopped and skips the ones completed.
+ *
+ * @param argc The number of arguments of the batch mode (the first one being its name)
+ * @param argv The arguments of the batch mode
+ * @return int The exit code of the batch mode (EXIT_FAILURE if a job failed)
+ */
+inline int run_batch(int argc, char **argv) {
+  CLI::App app("Run the jobs of a manifest (command lines of the app) in a single process.\n",
+               "anytime-pmnk-landscapes batch");
+
+  std::string manifest;
+  std::size_t jobs = 0;
+  set_batch_options(app, manifest, jobs);
+
+  CLI11_PARSE(app, argc, argv);
+
+  auto const commands = read_manifest(manifest);
+  instance_cache instances;
+
+  // every job is checked before any of them runs
+  std::vector<double> costs(commands.size());
+  std::vector<std::string> paths(commands.size());
+  std::map<std::string, std::size_t> outputs;
+  for (std::size_t i = 0; i < commands.size(); ++i) {
+    std::ostringstream log;
+    run_report report(log);
+    job_plan plan;
+    command_context const context{instances, log, report, &plan};
+    auto const code = run_command(
+        [&commands, i](CLI::App &command) { command.parse(commands[i].command, false); },
+        context);
+    if (code != EXIT_SUCCESS || plan.instance.empty() || plan.outputs.empty()) {
+      std::cerr << manifest << ":" << commands[i].line
+                << ": invalid job (every job needs an instance, an algorithm and an --output)\n"
+                << log.str();
+      return EXIT_FAILURE;
+    }
+    // the output files of the runs of every seed are checked too (unless merged)
+    for (auto const &output : plan.outputs) {
+      auto const [other, unique] = outputs.emplace(canonical_path(output), commands[i].line);
+      if (!unique) {
+        std::cerr << manifest << ":" << commands[i].line << ": invalid job (" << output
+                  << " is also written by the job of line " << other->second << ")\n";
+        return EXIT_FAILURE;
+      }
+    }
+    auto const cost = estimated_cost(plan.instance, plan.maxeval);
+    if (!cost) {
+      std::cerr << manifest << ":" << commands[i].line << ": invalid job (" << plan.instance
+                << " is not a rMNK-landscapes instance)\n";
+      return EXIT_FAILURE;
+    }
+    costs[i] = *cost;
+    paths[i] = canonical_path(plan.instance);
+    instances.reserve(paths[i]);
+  }
+
+  // the jobs of the same cost are grouped by instance, so an instance is loaded while they run
+  std::vector<std::size_t> order(commands.size());
+  std::iota(order.begin(), order.end(), std::size_t(0));
+  std::stable_sort(order.begin(), order.end(), [&costs, &paths](auto const a, auto const b) {
+    return costs[a] != costs[b] ? costs[a] > costs[b] : paths[a] < paths[b];
+  });
+
+  // the jobs stop cleanly (flushing their anytime data) if the process is terminated
+  apmnkl::stop_on_signals();
+
+  // the status of each job is reported once it ends
+  char const *const names[] = {"completed", "stopped", "failed", "skipped"};
+  std::mutex progress;
+  auto const run = [&commands, &paths, &instances, &manifest, &names,
+                    &progress](std::size_t const i) {
+    std::ostringstream log;
+    std::ostringstream messages;
+    auto status = job_status::skipped;
+    if (!apmnkl::stop_requested()) {
+      run_report runs(messages);
+      command_context const context{instances, log, runs, nullptr};
+      try {
+        auto const code = run_command(
+            [&commands, i](CLI::App &command) { command.parse(commands[i].command, false); },
+            context);
+        status = code != EXIT_SUCCESS ? job_status::failed
+                 : runs.stopped()     ? job_status::stopped
+                                      : job_status::completed;
+      } catch (std::exception const &e) {
+        log << "Error: " << e.what() << "\n";
+        status = job_status::failed;
+      }
+    }
+    instances.release(paths[i]);
+
+    std::lock_guard<std::mutex> lock(progress);
+    std::cerr << manifest << ":" << commands[i].line << ": "
+              << names[static_cast<std::size_t>(status)] << "\n"
+              << messages.str();
+    if (status == job_status::failed) {
+      std::cerr << log.str();
+    }
+    return status;
+  };
+
+  apmnkl::priv::thread_pool pool(jobs);
+  std::vector<std::future<job_status>> results;
+  for (auto const i : order) {
+    results.push_back(pool.submit([&run, i]() { return run(i); }));
+  }
+  std::size_t counts[4] = {};
+  for (auto &result : results) {
+    ++counts[static_cast<std::size_t>(result.get())];
+  }
+  std::cerr << "Jobs: " << commands.size() << " (" << counts[0] << " completed, " << counts[1]
+            << " stopped, " << counts[2] << " failed, " << counts[3] << " skipped)\n";
+  return counts[2] == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1 && std::string(argv[1]) == "batch") {
+    return run_batch(argc - 1, argv + 1);
+  }
+
+  instance_cache instances;
+  run_report report(std::cerr);
+  command_context const context{instances, std::cerr, report, nullptr};
+  return run_command([argc, argv](CLI::App &app) { app.parse(argc, argv); }, context);
+}
@@ -0,0 +1,52 @@
+/**
+ * @file convert.cpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Converter of the text rmnk-landscapes instances (generated by the
+ *        rmnkGenerator.R script) to the binary instance format, which is
+ *        memory-mapped by the evaluator with no parsing nor copy.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+// CLI11 Command Line Parser
+#include <CLI/CLI.hpp>
+
+// anytime pmnk-landscapes (apmnkl) library includes
+#include <apmnkl/utils/rMNKEval.hpp>
+
+// Standard Includes
+#include <iostream>
+#include <string>
+
+int main(int argc, char **argv) {
+  // App Global Settings
+  CLI::App app(
+      "Convert a rmnk-landscapes instance to the binary (memory-mapped) instance format.\n",
+      "rmnk-convert");
+
+  // Positional Arguments
+  std::string input;
+  std::string output;
+  app.add_option("input", input,
+                 "= pmnk-landscapes instance file path\n(instances can be generated using the "
+                 "rmnkGenerator.R script)")
+      ->required()
+      ->check(CLI::ExistingFile);
+  app.add_option("output", output, "= binary instance file path")->required();
+
+  // Main App
+  app.callback([&]() {
+    apmnkl::priv::RMNKEval eval(input.c_str());
+    eval.save(output.c_str());
+
+    std::cerr << "Converted " << input << " (M = " << eval.getM() << ", N = " << eval.getN()
+              << ", K = " << eval.getK() << ") to " << output << "\n";
+  });
+
+  CLI11_PARSE(app, argc, argv);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,314 @@
+/**
+ * @file fixtures.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Fixtures of the benchmark suite: rho-mnk instances of the parameter grid of
+ *        instances/generator (generated once and cached in the binary instance format),
+ *        random solutions and synthetic non-dominated fronts. Every fixture is seeded, so
+ *        the benchmarks always measure the same work.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef BENCHMARKS_FIXTURES_HPP
+#define BENCHMARKS_FIXTURES_HPP
+
+// Google Benchmark
+#include <benchmark/benchmark.h>
+
+// anytime pmnk-landscapes (apmnkl) library includes
+#include <apmnkl/utils/rMNKEval.hpp>
+#include <apmnkl/utils/solution.hpp>
+
+// Standard Includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace apmnkl {
+
+namespace benchmarks {
+
+/// Seed of the generator of the instances (the first instance of each tuple of parameters)
+inline constexpr unsigned instance_seed = 0;
+
+/// Seed of the generators of the solutions and fronts used by the benchmarks
+inline constexpr unsigned fixture_seed = 1;
+
+/// Parameters of a rho-mnk instance (the arguments of the rmnkGenerator.R script)
+struct instance_parameters {
+  double rho;
+  unsigned M;
+  unsigned N;
+  unsigned K;
+
+  /// Get the parameters given by the first four arguments (rho x 10, M, N, K) of a benchmark
+  static instance_parameters from(benchmark::State const &state) {
+    return {static_cast<double>(state.range(0)) / 10.0, static_cast<unsigned>(state.range(1)),
+            static_cast<unsigned>(state.range(2)), static_cast<unsigned>(state.range(3))};
+  }
+
+  /// Get the name of the instance (as named by produceAllInstances.py)
+  [[nodiscard]] std::string name() const {
+    std::ostringstream ss;
+    ss << "rmnk_" << std::fixed << std::setprecision(1) << rho << '_' << M << '_' << N << '_' << K
+       << '_' << instance_seed;
+    return ss.str();
+  }
+};
+
+/**
+ * @brief Register the arguments (rho x 10, M, N, K, extra...) of the instances of a sub-grid
+ *        of the parameter grid of instances/generator/produceAllInstances.py, skipping the
+ *        tuples of parameters the generator skips (K >= N or rho <= -1 / (M - 1)).
+ *
+ * @param b The benchmark.
+ * @param rhos The correlations between the objectives.
+ * @param Ms The numbers of objectives.
+ * @param Ns The sizes of the bit strings.
+ * @param Ks The numbers of epistatic interactions.
+ * @param extra The names and values of the extra arguments of the benchmark (their product
+ *        is taken).
+ */
+inline void instance_grid(benchmark::internal::Benchmark *b, std::vector<double> const &rhos,
+                          std::vector<unsigned> const &Ms, std::vector<unsigned> const &Ns,
+                          std::vector<unsigned> const &Ks,
+                          std::vector<std::pair<std::string, std::vector<std::int64_t>>> const
+                              &extra = {}) {
+  std::vector<std::string> names{"rho_x10", "M", "N", "K"};
+  std::vector<std::vector<std::int64_t>> args;
+  for (auto const M : Ms) {
+    for (auto const N : Ns) {
+      for (auto const K : Ks) {
+        for (auto const rho : rhos) {
+          if (K < N && (M == 1 || rho > -1.0 / (M - 1))) {
+            args.push_back({std::lround(rho * 10.0), M, N, K});
+          }
+        }
+      }
+    }
+  }
+  for (auto const &[name, values] : extra) {
+    names.push_back(name);
+    std::vector<std::vector<std::int64_t>> product;
+    for (auto const &arg : args) {
+      for (auto const value : values) {
+        product.push_back(arg);
+        product.back().push_back(value);
+      }
+    }
+    args = std::move(product);
+  }
+
+  b->ArgNames(names);
+  for (auto const &arg : args) {
+    b->Args(arg);
+  }
+}
+
+/**
+ * @brief Write a rho-mnk instance in the text format of the rmnkGenerator.R script. The
+ *        instance is generated the same way (random links, and contributions given by the
+ *        normal cdf of multivariate normal vectors with correlations 2 sin(pi / 6 rho)), but
+ *        with the C++ generators, so it does not need R to be available.
+ *
+ * @param parameters The parameters of the instance.
+ * @param path The path of the instance file.
+ */
+inline void write_instance(instance_parameters const &parameters, std::string const &path) {
+  auto const [rho, M, N, K] = parameters;
+  std::mt19937 generator(instance_seed);
+
+  // links (the K bits each bit interacts with, identical for every objective)
+  std::vector<std::vector<unsigned>> links(N);
+  std::vector<unsigned> bits;
+  for (unsigned i = 0; i < N; ++i) {
+    bits.resize(N);
+    std::iota(bits.begin(), bits.end(), 0u);
+    bits.erase(bits.begin() + i);
+    for (unsigned j = 0; j < K; ++j) {
+      std::uniform_int_distribution<std::size_t> distrib(j, bits.size() - 1);
+      std::swap(bits[j], bits[distrib(generator)]);
+    }
+    links[i].assign(bits.begin(), bits.begin() + K);
+  }
+
+  // cholesky factor of the correlation matrix of the multivariate normal law
+  double const pi = std::acos(-1.0);
+  std::vector<double> L(std::size_t(M) * M, 0.0);
+  for (unsigned a = 0; a < M; ++a) {
+    for (unsigned b = 0; b <= a; ++b) {
+      double sum = a == b ? 1.0 : 2.0 * std::sin(pi / 6.0 * rho);
+      for (unsigned c = 0; c < b; ++c) {
+        sum -= L[a * M + c] * L[b * M + c];
+      }
+      L[a * M + b] = a == b ? std::sqrt(sum) : sum / L[b * M + b];
+    }
+  }
+
+  std::ofstream file(path);
+  file << "c file generated by the benchmark fixtures with seed " << instance_seed << '\n';
+  file << "c the links are random and identical for every objective functions\n";
+  file << "p rMNK " << rho << ' ' << M << ' ' << N << ' ' << K << '\n';
+
+  file << "p links\n";
+  for (unsigned i = 0; i < N; ++i) {
+    for (unsigned n = 0; n < M; ++n) {
+      file << i << ' ';
+    }
+    file << '\n';
+    for (auto const link : links[i]) {
+      for (unsigned n = 0; n < M; ++n) {
+        file << link << ' ';
+      }
+      file << '\n';
+    }
+  }
+
+  file << "p tables\n" << std::setprecision(17);
+  std::normal_distribution<double> normal;
+  std::vector<double> z(M);
+  for (std::size_t row = 0; row < (std::size_t(N) << (K + 1)); ++row) {
+    std::generate(z.begin(), z.end(), [&]() { return normal(generator); });
+    for (unsigned a = M; a-- > 0;) {
+      double x = 0.0;
+      for (unsigned b = 0; b <= a; ++b) {
+        x += L[a * M + b] * z[b];
+      }
+      z[a] = x;
+    }
+    for (auto const x : z) {
+      file << 0.5 * std::erfc(-x / std::sqrt(2.0)) << ' ';
+    }
+    file << '\n';
+  }
+}
+
+/// Get the directory of the cached instances ($APMNKL_BENCHMARK_INSTANCES, or a temporary one)
+inline std::filesystem::path instance_directory() {
+  if (auto const *directory = std::getenv("APMNKL_BENCHMARK_INSTANCES")) {
+    return directory;
+  }
+  return std::filesystem::temp_directory_path() / "apmnkl-benchmarks";
+}
+
+/**
+ * @brief Get the evaluator of an instance of the grid. The instance is generated the first
+ *        time it is used and cached (in the binary format) in the instance directory, and the
+ *        evaluators are shared by the benchmarks of a process.
+ *
+ * @param parameters The parameters of the instance.
+ * @return std::shared_ptr<priv::RMNKEval const> The evaluator of the instance.
+ */
+inline std::shared_ptr<priv::RMNKEval const> instance(instance_parameters const &parameters) {
+  static std::mutex mutex;
+  static std::map<std::string, std::shared_ptr<priv::RMNKEval const>> evaluators;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto const name = parameters.name();
+  if (auto const it = evaluators.find(name); it != evaluators.end()) {
+    return it->second;
+  }
+
+  auto const directory = instance_directory();
+  auto const path = directory / (name + ".bin");
+  if (!std::filesystem::exists(path)) {
+    std::filesystem::create_directories(directory);
+    auto const text = directory / (name + ".dat");
+    auto const partial = directory / (name + ".bin.tmp");
+    write_instance(parameters, text.string());
+    priv::RMNKEval(text.string().c_str()).save(partial.string().c_str());
+    std::filesystem::rename(partial, path);
+    std::filesystem::remove(text);
+  }
+  return evaluators[name] = std::make_shared<priv::RMNKEval const>(path.string().c_str());
+}
+
+/**
+ * @brief Get random (evaluated) solutions of an instance.
+ *
+ * @tparam S The type for the solutions.
+ * @param eval The evaluator of the instance.
+ * @param count The number of solutions.
+ * @return std::vector<S> The solutions.
+ */
+template <typename S = priv::solution>
+std::vector<S> random_solutions(priv::RMNKEval const &eval, std::size_t const count) {
+  std::mt19937 generator(fixture_seed);
+  std::vector<S> solutions;
+  solutions.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    solutions.emplace_back(priv::solution::random_solution(eval, generator));
+  }
+  return solutions;
+}
+
+/**
+ * @brief Get a synthetic front, i.e. mutually non-dominated points drawn uniformly on the
+ *        positive orthant of the unit sphere (within the [0, 1] objective space of the
+ *        instances). The fronts of the instances of a given size are not known beforehand,
+ *        hence the benchmarks of the archives and of the hypervolume use these ones.
+ *
+ * @param M The number of objectives.
+ * @param size The number of points.
+ * @return std::vector<objective_vector> The points of the front.
+ */
+inline std::vector<objective_vector> synthetic_front(std::size_t const M, std::size_t const size) {
+  std::mt19937 generator(fixture_seed);
+  std::normal_distribution<double> normal;
+  std::vector<objective_vector> front(size, objective_vector(M));
+  for (auto &point : front) {
+    double norm = 0.0;
+    for (auto &x : point) {
+      x = std::abs(normal(generator));
+      norm += x * x;
+    }
+    for (auto &x : point) {
+      x /= std::sqrt(norm);
+    }
+  }
+  return front;
+}
+
+/**
+ * @brief Get solutions with a synthetic front as their objective vectors (and random decision
+ *        vectors of N bits).
+ *
+ * @param front The objective vectors of the solutions.
+ * @param N The size of the decision vectors.
+ * @return std::vector<priv::gasolution> The solutions.
+ */
+inline std::vector<priv::gasolution> front_solutions(std::vector<objective_vector> const &front,
+                                                     std::size_t const N) {
+  std::mt19937 generator(fixture_seed);
+  std::bernoulli_distribution distrib;
+  std::vector<priv::gasolution> solutions(front.size());
+  for (std::size_t i = 0; i < front.size(); ++i) {
+    auto &decision = solutions[i].decision_vector();
+    decision = decision_vector(N);
+    for (std::size_t j = 0; j < N; ++j) {
+      decision.set(j, distrib(generator));
+    }
+    solutions[i].set_objv(objective_vector(front[i]));
+  }
+  return solutions;
+}
+}  // namespace benchmarks
+}  // namespace apmnkl
+#endif  // BENCHMARKS_FIXTURES_HPP
@@ -0,0 +1,106 @@
+/**
+ * @file macro.cpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Macro-benchmarks of the search heuristics: evaluations per second (items_per_second)
+ *        of complete runs of GSEMO, PLS and IBEA, anytime hypervolume recording included.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+// Benchmark fixtures
+#include "fixtures.hpp"
+
+// anytime pmnk-landscapes (apmnkl) library includes
+#include <apmnkl/gsemo.hpp>
+#include <apmnkl/ibea.hpp>
+#include <apmnkl/operators.hpp>
+#include <apmnkl/pls.hpp>
+
+// Standard Includes
+#include <cstdint>
+#include <optional>
+#include <random>
+
+namespace {
+
+using namespace apmnkl::benchmarks;
+
+/// Maximum number of evaluations of a run
+constexpr std::size_t maxeval = 10000;
+
+/// Seed of the runs
+constexpr unsigned run_seed = 0;
+
+void run_grid(benchmark::internal::Benchmark *b) {
+  instance_grid(b, {-0.2, 0.0, 0.7}, {2, 3, 5}, {64}, {4});
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+/// Report the evaluations per second and the size of the approximation set of the runs
+/// (PLS may stop before maxeval, every run performs the same evaluations as the last one)
+template <typename A>
+void report(benchmark::State &state, A const &algorithm) {
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(algorithm.evaluations()));
+  state.counters["evaluations"] = static_cast<double>(algorithm.evaluations());
+  state.counters["solutions"] = static_cast<double>(algorithm.solutions().size());
+}
+
+void gsemo_run(benchmark::State &state) {
+  auto const eval = instance(instance_parameters::from(state));
+  std::optional<apmnkl::gsemo> gsemo;
+  for (auto _ : state) {
+    gsemo.emplace(eval, run_seed);
+    gsemo->run(maxeval);
+  }
+  report(state, *gsemo);
+}
+BENCHMARK(gsemo_run)->Apply(run_grid);
+
+void pls_run(benchmark::State &state) {
+  using pls = apmnkl::pls;
+
+  auto const eval = instance(instance_parameters::from(state));
+  std::optional<pls> algorithm;
+  for (auto _ : state) {
+    algorithm.emplace(eval, run_seed);
+    algorithm->run(maxeval, pls::pac::non_dominating, pls::pne::best_improvement);
+  }
+  report(state, *algorithm);
+}
+BENCHMARK(pls_run)->Apply(run_grid);
+
+/// IBEA (population of 100, one-point crossover, 1/N uniform mutation, binary tournament)
+template <typename I>
+void ibea_run(benchmark::State &state, I const &indicator) {
+  auto const parameters = instance_parameters::from(state);
+  auto const eval = instance(parameters);
+  std::size_t const population = 100;
+
+  std::optional<apmnkl::ibea> ibea;
+  for (auto _ : state) {
+    ibea.emplace(eval, run_seed);
+    std::mt19937 rng(run_seed);
+    ibea->run(maxeval, population, maxeval, 0.05, indicator,
+              apmnkl::crossover::npc<std::mt19937>(1, 1.0, rng),
+              apmnkl::mutation::um<std::mt19937>(1.0 / parameters.N, rng),
+              apmnkl::selection::kwt<std::mt19937>(2, population, rng), false);
+  }
+  report(state, *ibea);
+}
+
+void ibea_eps_run(benchmark::State &state) {
+  ibea_run(state, apmnkl::indicator::eps());
+}
+BENCHMARK(ibea_eps_run)->Apply(run_grid);
+
+void ibea_ihd_run(benchmark::State &state) {
+  auto const M = static_cast<std::size_t>(state.range(1));
+  ibea_run(state, apmnkl::indicator::ihd(apmnkl::objective_vector(M, 0.0)));
+}
+BENCHMARK(ibea_ihd_run)->Apply(run_grid);
+}  // namespace
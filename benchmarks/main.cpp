@@ -0,0 +1,31 @@
+/**
+ * @file main.cpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Entry point of the benchmark suite. Every Google Benchmark option is available, e.g.
+ *        --benchmark_out=<file> --benchmark_out_format=json to track the results across
+ *        versions (the version of the library is recorded in the context of the results).
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+// Benchmark fixtures
+#include "fixtures.hpp"
+
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  benchmark::AddCustomContext("apmnkl_version", APMNKL_VERSION);
+  benchmark::AddCustomContext("apmnkl_instances",
+                              apmnkl::benchmarks::instance_directory().string());
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,360 @@
+/**
+ * @file micro.cpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Micro-benchmarks of the building blocks of the search heuristics: the evaluation,
+ *        the dominance tests, the non-dominated archives, the hypervolume and the IBEA
+ *        indicators and operators.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+// Benchmark fixtures
+#include "fixtures.hpp"
+
+// anytime pmnk-landscapes (apmnkl) library includes
+#include <apmnkl/operators.hpp>
+#include <apmnkl/utils/archive.hpp>
+#include <apmnkl/utils/solution.hpp>
+#include <apmnkl/utils/utils.hpp>
+#include <apmnkl/utils/wfg.hpp>
+
+// Standard Includes
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace apmnkl::benchmarks;
+
+using apmnkl::objective_vector;
+using apmnkl::priv::gasolution;
+
+/// Containers of non-dominated solutions maintained by add_non_dominated
+using vector_set = std::vector<gasolution>;
+using archive_set = apmnkl::priv::archive<gasolution>;
+
+// Evaluations (RMNKEval::eval)
+
+void rmnk_eval(benchmark::State &state) {
+  auto const parameters = instance_parameters::from(state);
+  auto const eval = instance(parameters);
+  auto solutions = random_solutions(*eval, 64);
+
+  std::vector<apmnkl::decision_vector> decisions;
+  for (auto const &s : solutions) {
+    decisions.push_back(s.decision_vector());
+  }
+  objective_vector objv(parameters.M);
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    eval->eval(decisions[i], objv);
+    benchmark::DoNotOptimize(objv.data());
+    benchmark::ClobberMemory();
+    i = i + 1 == decisions.size() ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(rmnk_eval)->Apply([](benchmark::internal::Benchmark *b) {
+  instance_grid(b, {0.0}, {2, 3, 5}, {18, 32, 64, 128}, {2, 4, 6, 8, 10});
+});
+
+// Incremental evaluations of a batch of N swap neighbors (RMNKEval::evalMoves)
+
+void rmnk_eval_swaps(benchmark::State &state) {
+  auto const parameters = instance_parameters::from(state);
+  auto const eval = instance(parameters);
+  auto solutions = random_solutions(*eval, 64);
+
+  std::mt19937 generator(0);
+  std::vector<std::vector<apmnkl::priv::NeighborMove>> moves(solutions.size());
+  for (std::size_t i = 0; i < solutions.size(); ++i) {
+    apmnkl::priv::neighborhood_sampler sampler(parameters.N, false, true);
+    sampler.draw(solutions[i].decision_vector(), generator, parameters.N, moves[i]);
+  }
+  apmnkl::priv::NeighborBatch batch;
+
+  std::size_t i = 0;
+  std::size_t neighbors = 0;
+  for (auto _ : state) {
+    eval->evalMoves(solutions[i].decision_vector(), solutions[i].objective_vector(), moves[i],
+                    batch);
+    benchmark::DoNotOptimize(batch.objectives.data());
+    benchmark::ClobberMemory();
+    neighbors += moves[i].size();
+    i = i + 1 == solutions.size() ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(neighbors));
+}
+BENCHMARK(rmnk_eval_swaps)->Apply([](benchmark::internal::Benchmark *b) {
+  instance_grid(b, {0.0}, {2, 3, 5}, {32, 128}, {2, 6});
+});
+
+// Dominance (solution::dominance)
+
+void solution_dominance(benchmark::State &state) {
+  auto const eval = instance(instance_parameters::from(state));
+  auto const solutions = random_solutions(*eval, 256);
+
+  std::size_t i = 0, j = 1;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(solutions[i].dominance(solutions[j]));
+    i = i + 1 == solutions.size() ? 0 : i + 1;
+    j = j + 3 >= solutions.size() ? j + 3 - solutions.size() : j + 3;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(solution_dominance)->Apply([](benchmark::internal::Benchmark *b) {
+  instance_grid(b, {-0.9, -0.7, -0.4, -0.2, 0.0, 0.2, 0.4, 0.7, 0.9}, {2, 3, 5}, {64}, {4});
+});
+
+// Non-dominated sets (add_non_dominated), holding a front of a given size
+
+/// Candidates dominated by a solution of the front (rejected, the set is left unmodified)
+template <typename Set>
+void add_non_dominated_rejected(benchmark::State &state) {
+  auto const M = static_cast<std::size_t>(state.range(0));
+  auto const size = static_cast<std::size_t>(state.range(1));
+  auto const front = synthetic_front(M, size);
+
+  Set set;
+  for (auto &s : front_solutions(front, 64)) {
+    apmnkl::priv::add_non_dominated(set, std::move(s));
+  }
+
+  auto dominated = front;
+  for (auto &point : dominated) {
+    for (auto &x : point) {
+      x *= 1.0 - 1e-6;
+    }
+  }
+  auto const candidates = front_solutions(dominated, 64);
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(apmnkl::priv::add_non_dominated(set, candidates[i]));
+    i = i + 1 == candidates.size() ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Candidates dominating a single solution of the front (which they replace)
+template <typename Set>
+void add_non_dominated_replacing(benchmark::State &state) {
+  auto const M = static_cast<std::size_t>(state.range(0));
+  auto const size = static_cast<std::size_t>(state.range(1));
+  auto front = synthetic_front(M, size);
+  auto solutions = front_solutions(front, 64);
+
+  Set set;
+  for (auto const &s : solutions) {
+    apmnkl::priv::add_non_dominated(set, s);
+  }
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    for (auto &x : front[i]) {
+      x *= 1.0 + 1e-12;
+    }
+    solutions[i].set_objv(objective_vector(front[i]));
+    benchmark::DoNotOptimize(apmnkl::priv::add_non_dominated(set, solutions[i]));
+    i = i + 1 == solutions.size() ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void set_sizes(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"M", "size"})->ArgsProduct({{2, 3, 5}, {16, 64, 256, 1024, 4096}});
+}
+
+BENCHMARK_TEMPLATE(add_non_dominated_rejected, vector_set)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(add_non_dominated_rejected, archive_set)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(add_non_dominated_replacing, vector_set)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(add_non_dominated_replacing, archive_set)->Apply(set_sizes);
+
+// Hypervolume (hvobj::insert), inserting the points of a front one by one
+
+void hvobj_insert(benchmark::State &state) {
+  auto const M = static_cast<std::size_t>(state.range(0));
+  auto const size = static_cast<std::size_t>(state.range(1));
+  auto const front = synthetic_front(M, size);
+  objective_vector const ref(M, 0.0);
+
+  apmnkl::priv::hvobj<double> hvo(ref);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    if (i == front.size()) {
+      state.PauseTiming();
+      hvo = apmnkl::priv::hvobj<double>(ref);
+      i = 0;
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(hvo.insert(front[i++]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(hvobj_insert)->ArgNames({"M", "size"})->ArgsProduct({{2, 3, 4, 5, 6, 7}, {16, 64, 256}});
+
+/// Monte Carlo estimate of the hypervolume (hvobj::insert with an approximation)
+void hvobj_insert_mc(benchmark::State &state) {
+  auto const M = static_cast<std::size_t>(state.range(0));
+  auto const size = static_cast<std::size_t>(state.range(1));
+  auto const front = synthetic_front(M, size);
+  objective_vector const ref(M, 0.0);
+  apmnkl::hv_approximation approximation;
+  approximation.samples = static_cast<std::size_t>(state.range(2));
+
+  apmnkl::priv::hvobj<double> hvo(ref, approximation);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    if (i == front.size()) {
+      state.PauseTiming();
+      hvo = apmnkl::priv::hvobj<double>(ref, approximation);
+      i = 0;
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(hvo.insert(front[i++]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(hvobj_insert_mc)
+    ->ArgNames({"M", "size", "samples"})
+    ->ArgsProduct({{5, 7}, {64, 256}, {100000, 1000000}});
+
+// IBEA indicators, on random solutions of the instances
+
+template <typename I>
+void indicator_values(benchmark::State &state, I const &indicator,
+                      std::vector<gasolution> const &population) {
+  std::size_t i = 0, j = 1;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(indicator(population[i], population[j]));
+    i = i + 1 == population.size() ? 0 : i + 1;
+    j = j + 3 >= population.size() ? j + 3 - population.size() : j + 3;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void indicator_eps(benchmark::State &state) {
+  auto const eval = instance(instance_parameters::from(state));
+  indicator_values(state, apmnkl::indicator::eps(), random_solutions<gasolution>(*eval, 100));
+}
+
+void indicator_ihd(benchmark::State &state) {
+  auto const parameters = instance_parameters::from(state);
+  auto const eval = instance(parameters);
+  indicator_values(state, apmnkl::indicator::ihd(objective_vector(parameters.M, 0.0)),
+                   random_solutions<gasolution>(*eval, 100));
+}
+
+/// Batch version of the ihd indicator (a solution against the whole population)
+void indicator_ihd_batch(benchmark::State &state) {
+  auto const parameters = instance_parameters::from(state);
+  auto const eval = instance(parameters);
+  auto const population = random_solutions<gasolution>(*eval, 100);
+  auto const indicator = apmnkl::indicator::ihd(objective_vector(parameters.M, 0.0));
+
+  std::vector<double> values(population.size());
+  std::size_t i = 0;
+  for (auto _ : state) {
+    indicator(population[i], population.begin(), population.end(), values.begin());
+    benchmark::DoNotOptimize(values.data());
+    benchmark::ClobberMemory();
+    i = i + 1 == population.size() ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(population.size()));
+}
+
+void indicator_objectives(benchmark::internal::Benchmark *b) {
+  instance_grid(b, {0.0}, {2, 3, 5}, {64}, {4});
+}
+
+BENCHMARK(indicator_eps)->Apply(indicator_objectives);
+BENCHMARK(indicator_ihd)->Apply(indicator_objectives);
+BENCHMARK(indicator_ihd_batch)->Apply(indicator_objectives);
+
+// IBEA operators, on random solutions of the instances
+
+void crossover_npc(benchmark::State &state) {
+  auto const eval = instance(instance_parameters::from(state));
+  auto population = random_solutions<gasolution>(*eval, 100);
+  std::mt19937 rng(fixture_seed);
+  apmnkl::crossover::npc<std::mt19937> crossover(static_cast<std::size_t>(state.range(4)), 1.0,
+                                                 rng);
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    crossover(population[i], population[i + 1]);
+    benchmark::ClobberMemory();
+    i = i + 2 == population.size() ? 0 : i + 2;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(crossover_npc)->Apply([](benchmark::internal::Benchmark *b) {
+  instance_grid(b, {0.0}, {2}, {18, 32, 64, 128}, {4}, {{"points", {1, 2, 4}}});
+});
+
+void crossover_uc(benchmark::State &state) {
+  auto const eval = instance(instance_parameters::from(state));
+  auto population = random_solutions<gasolution>(*eval, 100);
+  std::mt19937 rng(fixture_seed);
+  apmnkl::crossover::uc<std::mt19937> crossover(1.0, rng);
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    crossover(population[i], population[i + 1]);
+    benchmark::ClobberMemory();
+    i = i + 2 == population.size() ? 0 : i + 2;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void mutation_um(benchmark::State &state) {
+  auto const parameters = instance_parameters::from(state);
+  auto const eval = instance(parameters);
+  auto population = random_solutions<gasolution>(*eval, 100);
+  std::mt19937 rng(fixture_seed);
+  apmnkl::mutation::um<std::mt19937> mutation(1.0 / parameters.N, rng);
+
+  std::size_t i = 0;
+  for (auto _ : state) {
+    mutation(population[i]);
+    benchmark::ClobberMemory();
+    i = i + 1 == population.size() ? 0 : i + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void operator_sizes(benchmark::internal::Benchmark *b) {
+  instance_grid(b, {0.0}, {2}, {18, 32, 64, 128}, {4});
+}
+
+BENCHMARK(crossover_uc)->Apply(operator_sizes);
+BENCHMARK(mutation_um)->Apply(operator_sizes);
+
+/// K-way tournament filling a matting pool the size of the population
+void selection_kwt(benchmark::State &state) {
+  auto const eval = instance(instance_parameters::from(state));
+  auto population = random_solutions<gasolution>(*eval, 100);
+  std::mt19937 rng(fixture_seed);
+  std::uniform_real_distribution<double> fitness(-1.0, 0.0);
+  for (auto &s : population) {
+    s.set_fitness(fitness(rng));
+  }
+  apmnkl::selection::kwt<std::mt19937> selection(static_cast<std::size_t>(state.range(4)),
+                                                 population.size(), rng);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(selection(population));
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(population.size()));
+}
+BENCHMARK(selection_kwt)->Apply([](benchmark::internal::Benchmark *b) {
+  instance_grid(b, {0.0}, {2}, {18, 128}, {4}, {{"tournament", {2, 4}}});
+});
+}  // namespace
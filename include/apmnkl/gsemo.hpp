@@ -15,11 +15,20 @@
 #define GSEMO_HPP
 
 #include <algorithm>
-#include <csignal>
+#include <chrono>
 #include <iomanip>
+#include <memory>
 #include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
+#include "utils/anytime.hpp"
+#include "utils/budget.hpp"
+#include "utils/cache.hpp"
+#include "utils/checkpoint.hpp"
 #include "utils/solution.hpp"
+#include "utils/thread_pool.hpp"
 #include "utils/utils.hpp"
 #include "utils/wfg.hpp"
 
@@ -31,17 +40,55 @@ class gsemo {
   using hv_type = typename objv_type::value_type;
   using solution_type = typename priv::solution;
 
+ private:
+  std::shared_ptr<priv::RMNKEval const> m_evaluator;
+
  public:
-  priv::RMNKEval eval;
+  /// The (read-only) evaluator of the instance, possibly shared with other runs
+  priv::RMNKEval const &eval;
 
  private:
   std::mt19937 m_generator;
 
-  priv::hvobj<hv_type> m_hvo;
-  std::vector<solution_type> m_solutions;
-  std::vector<std::tuple<std::size_t, hv_type>> m_anytime;
+  priv::archive<solution_type> m_solutions;
+  priv::anytime_recorder<hv_type> m_anytime;
+  priv::time_budget m_budget;
+
+  // scratch offspring (and its flipped bits), only copied into the archive if accepted
+  solution_type m_offspring;
+  std::vector<unsigned> m_flipped;
+
+  // cache of the evaluations of the offspring (of the sequential run), and its hits
+  evaluation_cache_policy m_cache_policy;
+  priv::evaluation_cache m_cache;
+  std::size_t m_cache_hits = 0;
+
+  /// Independent GSEMO run (archive, generator, scratch offspring and evaluation cache, with
+  /// its hits in the current epoch) of the island model
+  struct island {
+    priv::archive<solution_type> solutions;
+    std::mt19937 generator;
+    solution_type offspring;
+    std::vector<unsigned> flipped;
+    priv::evaluation_cache cache;
+    std::size_t hits = 0;
+  };
+
+  std::size_t m_islands = 1;
+  std::size_t m_migration_interval = 1000;
+  std::vector<island> m_island_states;
+  std::unique_ptr<priv::thread_pool> m_pool;
+
+  // state of a resumable run: the evaluations performed (when it stopped), and whether the
+  // next run resumes it (loaded from a checkpoint)
+  std::size_t m_evaluation = 0;
+  bool m_resumable = false;
+  bool m_resumed = false;
 
  public:
+  /// The type for the anytime data rows <evaluation, hypervolume, elapsed>
+  using anytime_row_type = priv::anytime_recorder<hv_type>::row_type;
+
   /**
    * @brief Construct a new gsemo object
    *
@@ -57,9 +104,8 @@ class gsemo {
    */
   template <typename Str = std::string, typename Ref = objv_type>
   gsemo(Str &&instance, unsigned int const seed, Ref &&ref)
-      : eval(std::forward<Str>(instance).c_str())
-      , m_generator(seed)
-      , m_hvo(std::forward<Ref>(ref)) {}
+      : gsemo(std::make_shared<priv::RMNKEval const>(std::forward<Str>(instance).c_str()), seed,
+              std::forward<Ref>(ref)) {}
 
   /**
    * @brief Construct a new gsemo object
@@ -72,9 +118,37 @@ class gsemo {
    */
   template <typename Str = std::string>
   gsemo(Str &&instance, unsigned int const seed)
-      : eval(std::forward<Str>(instance).c_str())
+      : gsemo(std::make_shared<priv::RMNKEval const>(std::forward<Str>(instance).c_str()), seed) {}
+
+  /**
+   * @brief Construct a new gsemo object sharing the (read-only) evaluator of an instance,
+   *        e.g. with other runs of the algorithm executed concurrently.
+   *
+   * @tparam Ref the type used to store the reference point of the hvobj obj
+   * @param evaluator The evaluator of the "rmnk" instance to be used.
+   * @param seed The seed used by the pseudo random number generator used in GSEMO
+   * @param ref The reference point considered by hypervolume indicator whilst running the
+   * algorithms (anytime measure)
+   */
+  template <typename Ref = objv_type>
+  gsemo(std::shared_ptr<priv::RMNKEval const> evaluator, unsigned int const seed, Ref &&ref)
+      : m_evaluator(std::move(evaluator))
+      , eval(*m_evaluator)
       , m_generator(seed)
-      , m_hvo(objv_type(eval.getM(), 0)) {}
+      , m_anytime(std::forward<Ref>(ref)) {}
+
+  /**
+   * @brief Construct a new gsemo object sharing the (read-only) evaluator of an instance,
+   *        e.g. with other runs of the algorithm executed concurrently.
+   *
+   * @param evaluator The evaluator of the "rmnk" instance to be used.
+   * @param seed The seed used by the pseudo random number generator used in GSEMO
+   */
+  gsemo(std::shared_ptr<priv::RMNKEval const> evaluator, unsigned int const seed)
+      : m_evaluator(std::move(evaluator))
+      , eval(*m_evaluator)
+      , m_generator(seed)
+      , m_anytime(objv_type(eval.getM(), 0)) {}
 
   /**
    * @brief Construct a new gsemo object
@@ -108,44 +182,365 @@ class gsemo {
    * solutions found by the GSEMO algorithm.
    */
   auto const &solutions() const {
-    return m_solutions;
+    return m_solutions.solutions();
   }
 
   /**
    * @brief Getter for the anytime data produced by this algorithm.
    *
-   * @return auto const& Read-Only reference to a vector of pairs <evaluation,
-   *         hypervolume> obtained in the run of the GSEMO algorithm.
+   * @return auto const& Read-Only reference to a vector of rows <evaluation,
+   *         hypervolume, elapsed> obtained in the run of the GSEMO algorithm.
    */
   auto const &anytime() const {
-    return m_anytime;
+    return m_anytime.rows();
+  }
+
+  /**
+   * @brief Set the policy followed when recording the anytime data (before running
+   *        the algorithm).
+   *
+   * @param policy The anytime recording policy.
+   */
+  void set_anytime_policy(anytime_policy const &policy) {
+    m_anytime.set_policy(policy);
+  }
+
+  /**
+   * @brief Set the sink receiving the anytime data rows while the algorithm runs (before
+   *        running the algorithm). By default the rows are kept in memory (see anytime()).
+   *
+   * @param sink The anytime data sink, or nullptr to keep the rows in memory.
+   */
+  void set_anytime_sink(std::shared_ptr<anytime_sink<anytime_row_type>> sink) {
+    m_anytime.set_sink(std::move(sink));
+  }
+
+  /**
+   * @brief Set a wall-clock time limit of the runs (stopping criterion, along with the
+   *        maximum number of evaluations and a stop request, see stop_on_signals).
+   *
+   * @param limit The time limit of a run (zero for no limit).
+   * @param check_interval The number of evaluations between two checks of the clock.
+   */
+  void set_time_limit(std::chrono::nanoseconds const limit, std::size_t const check_interval) {
+    m_budget.set(limit, check_interval);
+  }
+
+  /**
+   * @brief Use the island model: every island (run by its own thread) evolves its own archive
+   *        with its own generator, and the archives are merged into the archive of the
+   *        algorithm (where the anytime data is recorded) once every island has performed a
+   *        given number of evaluations. The merged archive then migrates to every island.
+   *        The run only depends on the seed, the number of islands and the interval.
+   *
+   * @param islands The number of islands (0 to use one per hardware thread, 1 to run the
+   *                sequential algorithm).
+   * @param migration_interval The number of evaluations performed by each island between
+   *                           two merges.
+   */
+  void set_islands(std::size_t const islands, std::size_t const migration_interval) {
+    m_islands = islands != 0 ? islands : std::max(1u, std::thread::hardware_concurrency());
+    m_migration_interval = std::max<std::size_t>(1, migration_interval);
+    m_pool = m_islands > 1 ? std::make_unique<priv::thread_pool>(m_islands - 1) : nullptr;
+  }
+
+  /**
+   * @brief Set the cache of the evaluations of the offspring (before running the algorithm).
+   *        An offspring found in the cache was already offered to the archive, which rejects it
+   *        again (the archive only improves), so its evaluation and archive update are skipped.
+   *        Every island has its own cache (of the given size), so a run still only depends on
+   *        the seed. If the hits are counted as evaluations the run is the same as without the
+   *        cache; otherwise the run (or an island) stops early once it found as many offspring
+   *        in a row in the cache as the maximum number of evaluations (the search stalled).
+   *
+   * @param policy The evaluation cache policy (the number of slots, and whether the hits are
+   *               counted as evaluations).
+   */
+  void set_evaluation_cache(evaluation_cache_policy const &policy) {
+    m_cache_policy = policy;
+  }
+
+  /**
+   * @brief Get the number of offspring of the last run found in the evaluation cache (a resumed
+   *        run included).
+   *
+   * @return std::size_t The number of cache hits.
+   */
+  [[nodiscard]] std::size_t cache_hits() const noexcept {
+    return m_cache_hits;
+  }
+
+  /**
+   * @brief Keep the runs resumable (before running the algorithm): a run stopped by the time
+   *        limit (or a stop request) does not record the rows of its last evaluation, as the
+   *        resumed run records them (see save_checkpoint).
+   *
+   * @param resumable Keep the runs resumable.
+   */
+  void set_resumable(bool const resumable) {
+    m_resumable = resumable;
+  }
+
+  /**
+   * @brief Check if the last run was stopped (by the time limit or a stop request) before
+   *        reaching the maximum number of evaluations.
+   *
+   * @return true If the run was stopped.
+   */
+  [[nodiscard]] bool stopped() const noexcept {
+    return m_budget.expired();
+  }
+
+  /**
+   * @brief Get the number of evaluations performed by the last run (a resumed run included,
+   *        they count from the start of the run).
+   *
+   * @return std::size_t The number of evaluations.
+   */
+  [[nodiscard]] std::size_t evaluations() const noexcept {
+    return m_evaluation;
+  }
+
+  /**
+   * @brief Save the state of a resumable run that was stopped into a (binary) checkpoint: the
+   *        archive, the island archives, the generators, the anytime data recorder, the
+   *        evaluation caches and the evaluations performed. A run resumed from the checkpoint
+   *        (with the same options) records the very same anytime data as a run that was not
+   *        stopped.
+   *
+   * @param os The output stream (in binary mode) where the checkpoint is written.
+   * @throws std::logic_error If the run is not resumable or was not stopped.
+   */
+  void save_checkpoint(std::ostream &os) const {
+    if (!m_resumable || !stopped()) {
+      throw std::logic_error("only a resumable run that was stopped can be checkpointed");
+    }
+    priv::checkpoint_writer writer(os);
+    priv::write_checkpoint_header(writer, "GSEMO", eval);
+    writer.write_state(m_generator);
+    writer.write(m_solutions);
+    writer.write(m_anytime);
+    writer.write_size(m_evaluation);
+    writer.write(m_cache);
+    writer.write_size(m_cache_hits);
+    writer.write_size(m_island_states.size());
+    for (auto const &is : m_island_states) {
+      writer.write(is.solutions);
+      writer.write_state(is.generator);
+      writer.write(is.cache);
+    }
+  }
+
+  /**
+   * @brief Load the state of a run from a checkpoint, which the next run resumes.
+   *
+   * @param is The input stream (in binary mode) holding the checkpoint.
+   * @throws std::runtime_error If the checkpoint is invalid, or does not hold a run of GSEMO
+   *         on the instance with the same number of islands.
+   */
+  void load_checkpoint(std::istream &is) {
+    priv::checkpoint_reader reader(is);
+    priv::read_checkpoint_header(reader, "GSEMO", eval);
+    reader.read_state(m_generator);
+    reader.read(m_solutions);
+    reader.read(m_anytime);
+    m_evaluation = reader.read_size();
+    reader.read(m_cache);
+    m_cache_hits = reader.read_size();
+    m_island_states = std::vector<island>(reader.read_length());
+    if (m_island_states.size() != (m_islands > 1 ? m_islands : 0)) {
+      throw std::runtime_error("the checkpoint holds a run with a different number of islands");
+    }
+    for (auto &state : m_island_states) {
+      reader.read(state.solutions);
+      reader.read_state(state.generator);
+      reader.read(state.cache);
+    }
+    m_resumed = true;
   }
 
   /**
    * @brief GSEMO implementation runner. This effectively starts the algorithm
-   * and runs it until the maximum number of evaluations has been reached.
+   * and runs it until the maximum number of evaluations has been reached (or the
+   * time limit, or a stop request). The run loaded from a checkpoint is resumed.
    *
    * @param maxeval The maximum number of evaluations performed by GSEMO
    * (stopping criterion)
    */
   void run(std::size_t maxeval) {
-    auto rand_solution = solution_type::random_solution(eval, m_generator);
-    m_hvo.insert(rand_solution.objective_vector());
+    m_anytime.start();
+    m_budget.start();
+    auto const resumed = std::exchange(m_resumed, false);
+    if (m_islands > 1) {
+      m_run_islands(maxeval, resumed);
+      return;
+    }
 
-    add_non_dominated(m_solutions, std::move(rand_solution));
-    m_anytime.push_back({0, m_hvo.value()});
+    std::size_t evaluation = 0;
+    if (resumed) {
+      evaluation = m_evaluation;
+    } else {
+      auto rand_solution = solution_type::random_solution(eval, m_generator);
+      m_anytime.insert(rand_solution.objective_vector(), 0);
+      m_cache = m_make_cache();
+      m_cache_hits = 0;
+      m_cache_insert(m_cache, rand_solution);
+      add_non_dominated(m_solutions, std::move(rand_solution));
+    }
 
-    for (std::size_t i = 0; i < maxeval; ++i) {
+    // offspring found in a row in the cache (whose hits are not counted as evaluations)
+    std::size_t repeats = 0;
+    while (evaluation < maxeval && !m_budget.expired(evaluation)) {
       std::uniform_int_distribution<std::size_t> randint(0, m_solutions.size() - 1);
 
       std::size_t index = randint(m_generator);
-      auto solution =
-          solution_type::uniform_bit_flip_solution(eval, m_generator, m_solutions[index]);
+      solution_type::uniform_bit_flips(eval.getN(), m_generator, m_flipped);
+      if (m_breed(m_solutions[index], m_flipped, m_offspring, m_cache)) {
+        ++m_cache_hits;
+        if (m_cache_policy.count_hits) {
+          ++evaluation;
+        } else if (++repeats >= maxeval) {
+          break;
+        }
+        continue;
+      }
+      repeats = 0;
+      ++evaluation;
+
+      if (add_non_dominated(m_solutions, m_offspring)) {
+        m_anytime.insert(m_solutions.back().objective_vector(), evaluation);
+      }
+    }
+    m_evaluation = evaluation;
+    m_finish(evaluation);
+  }
+
+ private:
+  /**
+   * @brief Island model runner: the islands evolve concurrently for an epoch (a migration
+   *        interval), then their archives are merged (in the order of the islands) and the
+   *        anytime data of the merged archive is recorded at the evaluations performed so far.
+   *        The time limit (and stop request) is checked between epochs. An island whose
+   *        search stalled (see set_evaluation_cache) performs fewer evaluations in its epoch,
+   *        and the run stops once every island stalled.
+   *
+   * @param maxeval The maximum number of evaluations performed by all the islands.
+   * @param resumed Resume the run loaded from a checkpoint.
+   */
+  void m_run_islands(std::size_t const maxeval, bool const resumed) {
+    auto &islands = m_island_states;
+    std::size_t evaluation = 0;
+    if (resumed) {
+      evaluation = m_evaluation;
+    } else {
+      islands = std::vector<island>(m_islands);
+      m_cache_hits = 0;
+      for (auto &is : islands) {
+        is.generator.seed(m_generator());
+        is.cache = m_make_cache();
+        auto rand_solution = solution_type::random_solution(eval, is.generator);
+        m_cache_insert(is.cache, rand_solution);
+        add_non_dominated(is.solutions, std::move(rand_solution));
+      }
+      m_merge(islands, 0);
+    }
+
+    while (evaluation < maxeval && !m_budget.expired(evaluation)) {
+      auto const epoch = std::min(m_migration_interval * islands.size(), maxeval - evaluation);
+      std::vector<std::size_t> performed(islands.size());
+      m_pool->parallel_for(islands.size(), [&](std::size_t const first, std::size_t const last) {
+        for (std::size_t i = first; i < last; ++i) {
+          auto const count = epoch * (i + 1) / islands.size() - epoch * i / islands.size();
+          if (evaluation != 0) {
+            for (auto const &solution : m_solutions) {
+              add_non_dominated(islands[i].solutions, solution);
+            }
+          }
+          performed[i] = m_evolve(islands[i], count, maxeval);
+        }
+      });
+      std::size_t total = 0;
+      for (std::size_t i = 0; i < islands.size(); ++i) {
+        total += performed[i];
+        m_cache_hits += std::exchange(islands[i].hits, 0);
+      }
+      evaluation += total;
+      m_merge(islands, evaluation);
+      if (total == 0) {
+        break;
+      }
+    }
+    m_evaluation = evaluation;
+    m_finish(evaluation);
+  }
+
+  /// Record the end of a run (unless it is resumable and was stopped) and flush its data
+  void m_finish(std::size_t const evaluation) {
+    if (!m_resumable || !stopped()) {
+      m_anytime.finish(evaluation);
+    }
+    m_anytime.flush();
+  }
+
+  /// Perform a number of GSEMO iterations on an island (fewer if its search stalled, i.e. it
+  /// found maxeval offspring in a row in the cache), and return the evaluations performed
+  std::size_t m_evolve(island &is, std::size_t const count, std::size_t const maxeval) const {
+    std::size_t i = 0;
+    std::size_t repeats = 0;
+    while (i < count) {
+      std::uniform_int_distribution<std::size_t> randint(0, is.solutions.size() - 1);
+
+      std::size_t index = randint(is.generator);
+      solution_type::uniform_bit_flips(eval.getN(), is.generator, is.flipped);
+      if (m_breed(is.solutions[index], is.flipped, is.offspring, is.cache)) {
+        ++is.hits;
+        if (m_cache_policy.count_hits) {
+          ++i;
+        } else if (++repeats >= maxeval) {
+          break;
+        }
+        continue;
+      }
+      repeats = 0;
+      ++i;
+      add_non_dominated(is.solutions, is.offspring);
+    }
+    return i;
+  }
+
+  /// Make an (empty) evaluation cache following the policy
+  [[nodiscard]] priv::evaluation_cache m_make_cache() const {
+    if (m_cache_policy.slots == 0) {
+      return priv::evaluation_cache();
+    }
+    return priv::evaluation_cache(m_cache_policy.slots, eval.getN(), eval.getM());
+  }
+
+  /// Insert an evaluated solution into an evaluation cache (if enabled)
+  static void m_cache_insert(priv::evaluation_cache &cache, solution_type const &solution) {
+    if (cache.enabled()) {
+      cache.insert(solution.decision_vector(), solution.objective_vector());
+    }
+  }
+
+  /// Breed the offspring of a parent (flipping the given bits), evaluated unless found in the
+  /// cache, and return true on a cache hit (the offspring was already offered to the archive)
+  bool m_breed(solution_type const &parent, std::vector<unsigned> const &flipped,
+               solution_type &offspring, priv::evaluation_cache &cache) const {
+    if (!cache.enabled()) {
+      offspring.assign_flipped(eval, parent, flipped);
+      return false;
+    }
+    return offspring.assign_flipped(eval, parent, flipped, cache);
+  }
 
-      auto sov = solution.objective_vector();
-      if (add_non_dominated(m_solutions, std::move(solution))) {
-        m_hvo.insert(sov);
-        m_anytime.push_back({i + 1, m_hvo.value()});
+  /// Merge the archives of the islands into the archive of the algorithm
+  void m_merge(std::vector<island> const &islands, std::size_t const evaluation) {
+    for (auto const &is : islands) {
+      for (auto const &solution : is.solutions) {
+        if (add_non_dominated(m_solutions, solution)) {
+          m_anytime.insert(m_solutions.back().objective_vector(), evaluation);
+        }
       }
     }
   }
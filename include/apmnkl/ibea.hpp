@@ -12,12 +12,23 @@
 #ifndef IBEA_HPP
 #define IBEA_HPP
 
-#include <csignal>
+#include <chrono>
+#include <cstdint>
 #include <iomanip>
+#include <memory>
 #include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "operators.hpp"
+#include "utils/anytime.hpp"
+#include "utils/budget.hpp"
+#include "utils/checkpoint.hpp"
+#include "utils/population.hpp"
+#include "utils/random.hpp"
 #include "utils/solution.hpp"
+#include "utils/thread_pool.hpp"
 #include "utils/utils.hpp"
 #include "utils/wfg.hpp"
 
@@ -29,17 +40,50 @@ class ibea {
   using hv_type = typename objv_type::value_type;
   using solution_type = typename priv::gasolution;
 
+ private:
+  std::shared_ptr<priv::RMNKEval const> m_evaluator;
+
  public:
-  priv::RMNKEval eval;
+  /// The (read-only) evaluator of the instance, possibly shared with other runs
+  priv::RMNKEval const &eval;
 
  private:
   std::mt19937 m_generator;
 
-  apmnkl::priv::hvobj<hv_type> m_hvo;
-  std::vector<std::tuple<std::size_t, std::size_t, hv_type>> m_anytime;
-  std::vector<solution_type> m_solutions;
+  priv::anytime_recorder<hv_type, std::size_t> m_anytime;
+  priv::time_budget m_budget;
+  priv::archive<solution_type> m_solutions;
+
+  // pairwise indicator values of the individuals of the population, kept across generations:
+  // each individual holds a slot of the matrix (m_slots, in population order), and I(x_a, x_b)
+  // of the individuals holding slots a and b is at m_indicators[a * m_stride + b], calculated
+  // the first time it is needed (flagged in m_known) and reused while both individuals live
+  std::vector<double> m_indicators;
+  std::vector<char> m_known;
+  std::size_t m_stride = 0;
+  std::vector<std::size_t> m_slots;
+  std::vector<std::size_t> m_free_slots;
+
+  // objective vectors of the population scaled for the computation of the adaptive factor
+  // (size x M, row-major), and the offspring (bred from the matting pool, reused)
+  std::vector<double> m_scaled;
+  std::vector<solution_type> m_offspring;
+  std::unique_ptr<priv::thread_pool> m_pool;
+  // vary the offspring in parallel (see set_parallel_variation), not only evaluate them
+  bool m_parallel_variation = false;
+
+  // state of a resumable run: the population, evaluations and generations (when it stopped),
+  // and whether the next run resumes it (loaded from a checkpoint)
+  priv::population m_population;
+  std::size_t m_evaluation = 0;
+  std::size_t m_generation = 0;
+  bool m_resumable = false;
+  bool m_resumed = false;
 
  public:
+  /// The type for the anytime data rows <evaluation, generation, hypervolume, elapsed>
+  using anytime_row_type = priv::anytime_recorder<hv_type, std::size_t>::row_type;
+
   /**
    * @brief Construct a new ibea object
    *
@@ -53,9 +97,8 @@ class ibea {
    */
   template <typename Str = std::string, typename Ref = objv_type>
   ibea(Str &&instance, unsigned int const seed, Ref &&ref)
-      : eval(std::forward<Str>(instance).c_str())
-      , m_generator(seed)
-      , m_hvo(std::forward<Ref>(ref)) {}
+      : ibea(std::make_shared<priv::RMNKEval const>(std::forward<Str>(instance).c_str()), seed,
+              std::forward<Ref>(ref)) {}
 
   /**
    * @brief Construct a new ibea object
@@ -67,9 +110,37 @@ class ibea {
    */
   template <typename Str = std::string>
   ibea(Str &&instance, unsigned int const seed)
-      : eval(std::forward<Str>(instance).c_str())
+      : ibea(std::make_shared<priv::RMNKEval const>(std::forward<Str>(instance).c_str()), seed) {}
+
+  /**
+   * @brief Construct a new ibea object sharing the (read-only) evaluator of an instance,
+   *        e.g. with other runs of the algorithm executed concurrently.
+   *
+   * @tparam Ref the type used to store the reference point of the hvobj obj
+   * @param evaluator The evaluator of the "rmnk" instance to be used.
+   * @param seed The seed used by the pseudo random number generator used in IBEA
+   * @param ref The reference point considered by hypervolume indicator whilst running the
+   * algorithms (anytime measure)
+   */
+  template <typename Ref = objv_type>
+  ibea(std::shared_ptr<priv::RMNKEval const> evaluator, unsigned int const seed, Ref &&ref)
+      : m_evaluator(std::move(evaluator))
+      , eval(*m_evaluator)
       , m_generator(seed)
-      , m_hvo(objv_type(eval.getM(), 0.0)) {}
+      , m_anytime(std::forward<Ref>(ref)) {}
+
+  /**
+   * @brief Construct a new ibea object sharing the (read-only) evaluator of an instance,
+   *        e.g. with other runs of the algorithm executed concurrently.
+   *
+   * @param evaluator The evaluator of the "rmnk" instance to be used.
+   * @param seed The seed used by the pseudo random number generator used in IBEA
+   */
+  ibea(std::shared_ptr<priv::RMNKEval const> evaluator, unsigned int const seed)
+      : m_evaluator(std::move(evaluator))
+      , eval(*m_evaluator)
+      , m_generator(seed)
+      , m_anytime(objv_type(eval.getM(), 0.0)) {}
 
   /**
    * @brief Construct a new ibea object
@@ -104,22 +175,165 @@ class ibea {
    *         of solution found by IBEA.
    */
   auto const &solutions() const {
-    return m_solutions;
+    return m_solutions.solutions();
   }
 
   /**
    * @brief Getter for the anytime data produced by this algorithm.
    *
-   * @return auto Read-Only reference to a vector of pairs <evaluation,
-   *         hypervolume> obtained in the run of IBEA.
+   * @return auto Read-Only reference to a vector of rows <evaluation, generation,
+   *         hypervolume, elapsed> obtained in the run of IBEA.
    */
   auto const &anytime() const {
-    return m_anytime;
+    return m_anytime.rows();
+  }
+
+  /**
+   * @brief Set the policy followed when recording the anytime data (before running
+   *        the algorithm).
+   *
+   * @param policy The anytime recording policy.
+   */
+  void set_anytime_policy(anytime_policy const &policy) {
+    m_anytime.set_policy(policy);
+  }
+
+  /**
+   * @brief Set the sink receiving the anytime data rows while the algorithm runs (before
+   *        running the algorithm). By default the rows are kept in memory (see anytime()).
+   *
+   * @param sink The anytime data sink, or nullptr to keep the rows in memory.
+   */
+  void set_anytime_sink(std::shared_ptr<anytime_sink<anytime_row_type>> sink) {
+    m_anytime.set_sink(std::move(sink));
+  }
+
+  /**
+   * @brief Set a wall-clock time limit of the runs (stopping criterion, along with the
+   *        maximum number of evaluations and a stop request, see stop_on_signals).
+   *
+   * @param limit The time limit of a run (zero for no limit).
+   * @param check_interval The number of evaluations between two checks of the clock.
+   */
+  void set_time_limit(std::chrono::nanoseconds const limit, std::size_t const check_interval) {
+    m_budget.set(limit, check_interval);
+  }
+
+  /**
+   * @brief Set the number of threads computing the pairwise indicator values, the adaptive
+   *        factor, the fitness of the population and the evaluations of the offspring (the
+   *        results do not depend on it, unless the variation runs in parallel too, see
+   *        set_parallel_variation).
+   *
+   * @param threads The number of threads (0 to use one per hardware thread).
+   */
+  void set_threads(std::size_t const threads) {
+    auto const count = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    m_pool = count > 1 ? std::make_unique<priv::thread_pool>(count - 1) : nullptr;
+  }
+
+  /**
+   * @brief Vary (crossover and mutation) the offspring in parallel too, not only evaluate
+   *        them (before running the algorithm, with more than one thread). The pairs of
+   *        offspring are split into one block per thread, bred by copies of the operators
+   *        (see their split member) drawing from streams seeded by the generator of the run
+   *        every generation, so a run depends on the seed and the number of threads. The
+   *        variation stays sequential if an operator can not be split.
+   *
+   * @param parallel Vary the offspring in parallel.
+   */
+  void set_parallel_variation(bool const parallel) {
+    m_parallel_variation = parallel;
+  }
+
+  /**
+   * @brief Keep the runs resumable (before running the algorithm): a run stopped by the time
+   *        limit (or a stop request) does not record the row of its last evaluation, as the
+   *        resumed run records it (see save_checkpoint).
+   *
+   * @param resumable Keep the runs resumable.
+   */
+  void set_resumable(bool const resumable) {
+    m_resumable = resumable;
+  }
+
+  /**
+   * @brief Check if the last run was stopped (by the time limit or a stop request) before
+   *        reaching the maximum number of evaluations (or generations).
+   *
+   * @return true If the run was stopped.
+   */
+  [[nodiscard]] bool stopped() const noexcept {
+    return m_budget.expired();
+  }
+
+  /**
+   * @brief Get the number of evaluations performed by the last run (a resumed run included,
+   *        they count from the start of the run).
+   *
+   * @return std::size_t The number of evaluations.
+   */
+  [[nodiscard]] std::size_t evaluations() const noexcept {
+    return m_evaluation;
+  }
+
+  /**
+   * @brief Save the state of a resumable run that was stopped into a (binary) checkpoint: the
+   *        archive, the population (with its fitness values), the generators of the algorithm
+   *        and of the operators, the anytime data recorder and the evaluations and generations
+   *        performed. The pairwise indicator values are not saved, they are calculated again
+   *        (when needed) by the resumed run, which records the very same anytime data as a
+   *        run that was not stopped (given the same options).
+   *
+   * @tparam Ops The types for the operators of the run (with a save member).
+   * @param os The output stream (in binary mode) where the checkpoint is written.
+   * @param operators The operators with a state (e.g. crossover, mutation and selection).
+   * @throws std::logic_error If the run is not resumable or was not stopped.
+   */
+  template <typename... Ops>
+  void save_checkpoint(std::ostream &os, Ops const &...operators) const {
+    if (!m_resumable || !stopped()) {
+      throw std::logic_error("only a resumable run that was stopped can be checkpointed");
+    }
+    priv::checkpoint_writer writer(os);
+    priv::write_checkpoint_header(writer, "IBEA", eval);
+    writer.write_state(m_generator);
+    writer.write(m_solutions);
+    writer.write(m_anytime);
+    writer.write(m_population);
+    writer.write_size(m_evaluation);
+    writer.write_size(m_generation);
+    (writer.write(operators), ...);
+  }
+
+  /**
+   * @brief Load the state of a run from a checkpoint, which the next run resumes.
+   *
+   * @tparam Ops The types for the operators of the run (with a load member).
+   * @param is The input stream (in binary mode) holding the checkpoint.
+   * @param operators The operators with a state, in the order they were saved.
+   * @throws std::runtime_error If the checkpoint is invalid, or does not hold a run of IBEA
+   *         on the instance.
+   */
+  template <typename... Ops>
+  void load_checkpoint(std::istream &is, Ops &...operators) {
+    priv::checkpoint_reader reader(is);
+    priv::read_checkpoint_header(reader, "IBEA", eval);
+    reader.read_state(m_generator);
+    reader.read(m_solutions);
+    reader.read(m_anytime);
+    reader.read(m_population);
+    m_evaluation = reader.read_size();
+    m_generation = reader.read_size();
+    (reader.read(operators), ...);
+    m_resumed = true;
   }
 
   /**
    * @brief IBEA implementation runner. This effectively starts the algorithm and runs it
-   * until the maximum number of evaluations has been reached.
+   * until the maximum number of evaluations has been reached (or the time limit, or a stop
+   * request). The time limit is checked between generations. The run loaded from a checkpoint
+   * is resumed.
    *
    * @tparam I The type used to store an IBEA indicator
    * @tparam S The type used to store an IBEA selection operator
@@ -178,174 +392,351 @@ class ibea {
     std::size_t evaluation = 0, gen = 0;
     double c = 1;
 
-    std::vector<solution_type> population;
-    population.reserve(pop_max);
+    priv::population population(eval.getM(), eval.getN());
+    m_clear_indicators();
+    m_anytime.start();
+    m_budget.start();
 
-    for (std::size_t i = 0; i < pop_max && evaluation < maxeval; ++i) {
-      auto sol = solution_type(solution_type::random_solution(eval, m_generator));
-      if (add_non_dominated(m_solutions, sol)) {
-        m_hvo.insert(sol.objective_vector());
-        m_anytime.push_back({evaluation, gen, m_hvo.value()});
+    if (std::exchange(m_resumed, false)) {
+      population = std::move(m_population);
+      evaluation = m_evaluation;
+      gen = m_generation;
+    } else {
+      population.reserve(pop_max);
+      for (std::size_t i = 0; i < pop_max && evaluation < maxeval; ++i) {
+        auto sol = solution_type(solution_type::random_solution(eval, m_generator));
+        if (add_non_dominated(m_solutions, sol)) {
+          m_anytime.insert(sol.objective_vector(), evaluation, gen);
+        }
+        population.push_back(sol);
+        ++evaluation;
       }
-      population.push_back(std::move(sol));
-      ++evaluation;
-    }
 
-    if (evaluation < maxeval) {
-      if constexpr (Adaptive) {
-        c = m_adaptive_factor(population, indicator);
+      if (evaluation < maxeval) {
+        if constexpr (Adaptive) {
+          c = m_adaptive_factor(population, indicator);
+        }
+        m_fitness_assignment(population, scaling_factor * c, indicator);
       }
-      m_fitness_assignment(population, scaling_factor * c, indicator);
     }
 
-    for (; evaluation < maxeval && gen < max_generations; ++gen) {
-      auto matting_pool = selection_method(population);
-
-      for (std::size_t i = 0; i < matting_pool.size() - 1; i += 2) {
-        crossover_method(matting_pool[i], matting_pool[i + 1]);
+    for (; evaluation < maxeval && gen < max_generations && !m_budget.expired(evaluation);
+         ++gen) {
+      auto const matting_pool = selection_method(population);
+      m_offspring.resize(matting_pool.size());
+      for (std::size_t i = 0; i < matting_pool.size(); ++i) {
+        population.copy_decision(matting_pool[i], m_offspring[i]);
+        m_offspring[i].set_fitness(population.fitness(matting_pool[i]));
       }
 
-      for (auto &individual : matting_pool) {
-        mutation_method(individual);
-        individual.eval(eval);
-      }
+      m_vary(crossover_method, mutation_method);
 
       if constexpr (Adaptive) {
         c = m_adaptive_factor(population, indicator);
       }
       m_fitness_assignment(population, scaling_factor * c, indicator);
 
-      for (auto &individual : matting_pool) {
+      for (auto const &individual : m_offspring) {
         if (add_non_dominated(m_solutions, individual)) {
-          m_hvo.insert(individual.objective_vector());
-          m_anytime.push_back({evaluation, gen, m_hvo.value()});
+          m_anytime.insert(individual.objective_vector(), evaluation, gen);
         }
-        population.push_back(std::move(individual));
+        population.push_back(individual, individual.fitness());
         ++evaluation;
       }
       m_environmental_selection(population, scaling_factor * c, pop_max, indicator);
     }
-    m_anytime.push_back({evaluation, gen, m_hvo.value()});
+    m_population = std::move(population);
+    m_evaluation = evaluation;
+    m_generation = gen;
+    if (!m_resumable || !stopped()) {
+      m_anytime.sample(evaluation, gen);
+    }
+    m_anytime.flush();
+  }
+
+  /**
+   * @brief Vary (crossover of the consecutive pairs, then mutation) and evaluate the offspring.
+   *        The variation draws from the operators in the order of the offspring, while the
+   *        evaluations run in parallel, unless the variation runs in parallel too (see
+   *        set_parallel_variation): every block of pairs is then varied and evaluated by a
+   *        thread, with copies of the operators of its own. The archive and the anytime data
+   *        are then updated in the order of the offspring.
+   *
+   * @tparam C The type used to store and IBEA crossover operator
+   * @tparam M The type used to store and IBEA mutation operator
+   * @param crossover_method The crossover method considered by the IBEA mutation operator
+   * @param mutation_method The mutation method considered by the IBEA mutation operator
+   */
+  template <typename C, typename M>
+  void m_vary(C &crossover_method, M &mutation_method) {
+    auto const size = m_offspring.size();
+    if constexpr (priv::is_splittable_v<C> && priv::is_splittable_v<M>) {
+      if (m_parallel_variation && m_pool) {
+        auto const blocks = m_pool->size() + 1;
+        auto const pairs = size / 2;
+        std::vector<std::uint64_t> seeds(2 * blocks);
+        for (auto &seed : seeds) {
+          seed = priv::random_bits(m_generator);
+        }
+        m_parallel_for(blocks, [&](std::size_t const first, std::size_t const last) {
+          for (std::size_t b = first; b < last; ++b) {
+            auto crossover = crossover_method.split(seeds[2 * b]);
+            auto mutation = mutation_method.split(seeds[2 * b + 1]);
+            // the last block also holds the odd offspring left (only mutated)
+            auto const begin = 2 * (pairs * b / blocks);
+            auto const end = b + 1 == blocks ? size : 2 * (pairs * (b + 1) / blocks);
+            for (std::size_t i = begin; i + 1 < end; i += 2) {
+              crossover(m_offspring[i], m_offspring[i + 1]);
+            }
+            for (std::size_t i = begin; i < end; ++i) {
+              mutation(m_offspring[i]);
+              m_offspring[i].eval(eval);
+            }
+          }
+        });
+        return;
+      }
+    }
+
+    for (std::size_t i = 0; i < size - 1; i += 2) {
+      crossover_method(m_offspring[i], m_offspring[i + 1]);
+    }
+    for (auto &individual : m_offspring) {
+      mutation_method(individual);
+    }
+    m_parallel_for(size, [this](std::size_t const first, std::size_t const last) {
+      for (std::size_t i = first; i < last; ++i) {
+        m_offspring[i].eval(eval);
+      }
+    });
   }
 
   /**
    * @brief Calculate objective functions lower and upper bounds
-   *        for scaling
+   *        for scaling (over the contiguous objective matrix)
    *
-   * @tparam S The type for the genetic algorithm's solution
    * @param population The IBEA population to be scaled
    * @return auto A pair containing the upper and lower objective value bounds
    */
-  template <typename S = solution_type>
-  auto m_objective_bounds(std::vector<S> const &population) {
+  auto m_objective_bounds(priv::population const &population) {
     auto ub = std::numeric_limits<typename objv_type::value_type>::min();
     auto lb = std::numeric_limits<typename objv_type::value_type>::max();
-    for (auto const &individual : population) {
-      for (auto const v : individual.objective_vector()) {
-        lb = std::min(lb, v);
-        ub = std::max(ub, v);
-      }
+    for (auto const v : population.objective_matrix()) {
+      lb = std::min(lb, v);
+      ub = std::max(ub, v);
     }
     return std::make_pair(lb, ub);
   }
 
   /**
    * @brief Scale population objective vectors values using the bounds
-   *        previously calculated for the population.
+   *        previously calculated for the population (into the m_scaled
+   *        matrix, reused between generations).
    *
-   * @tparam S The type for the genetic algorithm's solution
    * @param population The IBEA population to be scaled
    * @param lb The population objective vectors lower bound
    * @param ub the population objective vectors upper bound
-   * @return auto The population with the objective vectors scaled
    */
-  template <typename S = solution_type>
-  auto m_scale_objective_vectors(std::vector<S> const &population, double const lb,
+  void m_scale_objective_vectors(priv::population const &population, double const lb,
                                  double const ub) {
-    std::vector<S> s = population;
-    for (auto &individual : s) {
-      auto ov = individual.objective_vector();
-      for (auto &i : ov) {
-        i = (i - ub) / (ub - lb);
-      }
-      individual.set_objv(std::move(ov));
+    auto const &objectives = population.objective_matrix();
+    m_scaled.resize(objectives.size());
+    for (std::size_t i = 0; i < objectives.size(); ++i) {
+      m_scaled[i] = (objectives[i] - ub) / (ub - lb);
+    }
+  }
+
+  /// Get a view of the scaled objective vector of an individual
+  [[nodiscard]] priv::individual_view m_scaled_individual(std::size_t const i,
+                                                          std::size_t const M) const {
+    return priv::individual_view(priv::objective_row(m_scaled.data() + i * M, M), 0);
+  }
+
+  /**
+   * @brief Execute a task over the range [0, size), split into blocks among the
+   *        threads of the pool (or in the calling thread if there is no pool).
+   *
+   * @tparam F The type for the task (callable with the bounds [first, last) of a block).
+   * @param size The size of the range.
+   * @param task The task to be executed on every block of the range.
+   */
+  template <typename F>
+  void m_parallel_for(std::size_t const size, F &&task) {
+    if (m_pool) {
+      m_pool->parallel_for(size, std::forward<F>(task));
+    } else {
+      task(std::size_t(0), size);
     }
-    return s;
   }
 
   /**
    * @brief Calculate the adaptive factor for IBEA
    *
    * @tparam I The type for the IBEA indicator
-   * @tparam S The type for the genetic algorithm's solution
    * @param population The IBEA population to be scaled
    * @param indicator The indicator used by IBEA
    * @return auto The adaptive factor.
    */
-  template <typename I, typename S = solution_type>
-  auto m_adaptive_factor(std::vector<S> const &population, I &&indicator) {
+  template <typename I>
+  auto m_adaptive_factor(priv::population const &population, I &&indicator) {
     auto &&[lb, ub] = m_objective_bounds(population);
-    auto s = m_scale_objective_vectors(population, lb, ub);
-    auto c = std::numeric_limits<typename objv_type::value_type>::min();
-    for (std::size_t i = 0; i < s.size(); ++i) {
-      for (std::size_t j = 0; j < s.size(); ++j) {
-        if (i != j) {
-          c = std::max(c, std::abs(indicator(s[i], s[j])));
+    m_scale_objective_vectors(population, lb, ub);
+
+    // the maximum of each row, reduced afterwards (the result does not depend on the blocks)
+    auto const size = population.size();
+    auto const M = population.objectives();
+    std::vector<double> rows(size, std::numeric_limits<double>::min());
+    m_parallel_for(size, [&](std::size_t const first, std::size_t const last) {
+      for (std::size_t i = first; i < last; ++i) {
+        auto const scaled = m_scaled_individual(i, M);
+        for (std::size_t j = 0; j < size; ++j) {
+          if (i != j) {
+            rows[i] =
+                std::max(rows[i], std::abs(indicator(scaled, m_scaled_individual(j, M))));
+          }
         }
       }
+    });
+
+    auto c = std::numeric_limits<typename objv_type::value_type>::min();
+    for (auto const row : rows) {
+      c = std::max(c, row);
     }
     return c;
   }
 
+  /// Discard the pairwise indicator values (and the slots) of the previous run
+  void m_clear_indicators() {
+    m_indicators.clear();
+    m_known.clear();
+    m_stride = 0;
+    m_slots.clear();
+    m_free_slots.clear();
+  }
+
   /**
-   * @brief Calculate the fitness values for the population individuals.
+   * @brief Give a slot of the indicator matrix to the individuals that joined the population
+   *        (doubling the matrix when no slot is free). A slot is cleared when reused, i.e. its
+   *        row and column (the values of the individual that held it) are dropped in O(P).
+   *
+   * @param size The size of the population.
+   */
+  void m_acquire_slots(std::size_t const size) {
+    while (m_slots.size() < size) {
+      if (m_free_slots.empty()) {
+        auto const stride = std::max<std::size_t>(2 * m_stride, size);
+        std::vector<double> indicators(stride * stride);
+        std::vector<char> known(stride * stride, 0);
+        for (std::size_t a = 0; a < m_stride; ++a) {
+          std::copy_n(m_indicators.begin() + static_cast<std::ptrdiff_t>(a * m_stride), m_stride,
+                      indicators.begin() + static_cast<std::ptrdiff_t>(a * stride));
+          std::copy_n(m_known.begin() + static_cast<std::ptrdiff_t>(a * m_stride), m_stride,
+                      known.begin() + static_cast<std::ptrdiff_t>(a * stride));
+        }
+        for (auto slot = stride; slot > m_stride; --slot) {
+          m_free_slots.push_back(slot - 1);
+        }
+        m_indicators = std::move(indicators);
+        m_known = std::move(known);
+        m_stride = stride;
+      }
+
+      auto const slot = m_free_slots.back();
+      m_free_slots.pop_back();
+      for (std::size_t b = 0; b < m_stride; ++b) {
+        m_known[slot * m_stride + b] = 0;
+        m_known[b * m_stride + slot] = 0;
+      }
+      m_slots.push_back(slot);
+    }
+  }
+
+  /**
+   * @brief Get the indicator value I(x_a, x_b) of two individuals of the population,
+   *        calculating it only if it is not known yet. Concurrent calls must not share
+   *        the pair (a, b).
+   *
+   * @tparam I The type for the IBEA indicator.
+   * @param population The IBEA population.
+   * @param a The index of the first individual.
+   * @param b The index of the second individual.
+   * @param indicator The indicator used by IBEA.
+   * @return double The indicator value.
+   */
+  template <typename I>
+  double m_indicator(priv::population const &population, std::size_t const a,
+                     std::size_t const b, I &&indicator) {
+    auto const index = m_slots[a] * m_stride + m_slots[b];
+    if (!m_known[index]) {
+      m_indicators[index] = indicator(population[a], population[b]);
+      m_known[index] = 1;
+    }
+    return m_indicators[index];
+  }
+
+  /**
+   * @brief Calculate the fitness values for the population individuals. Only the indicator
+   *        values involving individuals that joined the population since the previous
+   *        generation are calculated, the others are kept in the indicator matrix.
    *
    * @tparam I The type for the IBEA indicator.
-   * @tparam S The type for the genetic algorithm's solution.
    * @param population The IBEA population to be scaled.
    * @param k IBEA scaling factor.
    * @param indicator The indicator used by IBEA.
    */
-  template <typename I, typename S = solution_type>
-  void m_fitness_assignment(std::vector<S> &population, double const k, I &&indicator) const {
-    for (std::size_t i = 0; i < population.size(); ++i) {
-      population[i].set_fitness(0);
-      for (std::size_t j = 0; j < population.size(); ++j) {
-        if (i != j) {
-          population[i].set_fitness(population[i].fitness() -
-                                    std::exp(-indicator(population[j], population[i]) / k));
+  template <typename I>
+  void m_fitness_assignment(priv::population &population, double const k, I &&indicator) {
+    APMNKL_PROFILE_SCOPE(fitness_assignment);
+    m_acquire_slots(population.size());
+    auto &fitness = population.fitness_values();
+    m_parallel_for(population.size(), [&](std::size_t const first, std::size_t const last) {
+      for (std::size_t i = first; i < last; ++i) {
+        double value = 0;
+        for (std::size_t j = 0; j < population.size(); ++j) {
+          if (i != j) {
+            value -= std::exp(-m_indicator(population, j, i, indicator) / k);
+          }
         }
+        fitness[i] = value;
       }
-    }
+    });
   }
 
   /**
    * @brief Do the environmental selection step on the IBEA population.
    *        Reduce the number of individuals (that was increased after the matting process)
-   *        to the maximum size allowed.
+   *        to the maximum size allowed. The slot of a removed individual is released.
    *
    * @tparam I The type for the IBEA indicator.
-   * @tparam S The type for the genetic algorithm's solution.
    * @param population The IBEA population from which the individuals will be selected.
    * @param k IBEA scaling factor.
    * @param population_max_size The max population size.
    * @param indicator The indicator used by IBEA.
    */
-  template <typename I, typename S = solution_type>
-  void m_environmental_selection(std::vector<S> &population, double const k,
+  template <typename I>
+  void m_environmental_selection(priv::population &population, double const k,
                                  std::size_t population_max_size, I &&indicator) {
+    APMNKL_PROFILE_SCOPE(environmental_selection);
+    m_acquire_slots(population.size());
+    auto &fitness = population.fitness_values();
     while (population.size() > population_max_size) {
       std::size_t worst = 0;
       for (std::size_t i = 0; i < population.size(); ++i) {
-        worst = population[i].fitness() < population[worst].fitness() ? i : worst;
+        worst = fitness[i] < fitness[worst] ? i : worst;
       }
 
-      std::swap(population[worst], population.back());
-      for (std::size_t i = 0; i < population.size() - 1; ++i) {
-        population[i].set_fitness(population[i].fitness() +
-                                  std::exp(-indicator(population.back(), population[i]) / k));
-      }
+      auto const last = population.size() - 1;
+      population.swap(worst, last);
+      std::swap(m_slots[worst], m_slots.back());
+
+      m_parallel_for(last, [&](std::size_t const first, std::size_t const end) {
+        for (std::size_t i = first; i < end; ++i) {
+          fitness[i] += std::exp(-m_indicator(population, last, i, indicator) / k);
+        }
+      });
       population.pop_back();
+      m_free_slots.push_back(m_slots.back());
+      m_slots.pop_back();
     }
   }
 };
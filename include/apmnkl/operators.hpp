@@ -13,14 +13,37 @@
 #ifndef IBEA_OPERATORS_HPP
 #define IBEA_OPERATORS_HPP
 
+#include <cstdint>
 #include <iostream>
 #include <random>
+#include <type_traits>
+#include <utility>
 
+#include "utils/checkpoint.hpp"
+#include "utils/population.hpp"
+#include "utils/profile.hpp"
+#include "utils/random.hpp"
 #include "utils/solution.hpp"
 #include "utils/wfg.hpp"
 
 namespace apmnkl {
 
+namespace priv {
+
+/// Check if a variation operator can be split into copies drawing from independent streams
+/// (i.e. it has a split(seed) member returning a copy of the operator)
+template <typename Op, typename = void>
+struct is_splittable : std::false_type {};
+
+template <typename Op>
+struct is_splittable<
+    Op, std::void_t<decltype(std::declval<Op const &>().split(std::uint64_t()))>>
+    : std::true_type {};
+
+template <typename Op>
+inline constexpr bool is_splittable_v = is_splittable<std::decay_t<Op>>::value;
+}  // namespace priv
+
 namespace indicator {
 /**
  * @brief Hypervolume Based IBEA indicator
@@ -50,15 +73,44 @@ struct ihd {
    */
   template <typename S = priv::gasolution>
   [[nodiscard]] double operator()(S const &s1, S const &s2) const {
-    auto const &o1 = s1.objective_vector();
-    auto const &o2 = s2.objective_vector();
-
-    if (priv::weakly_dominates(o1, o2)) {
-      return priv::point_hv(o2, m_ref) - priv::point_hv(o1, m_ref);
-    } else {
-      priv::hvobj<typename R::value_type> hvo(m_ref);
-      hvo.insert(o1), hvo.insert(o2);
-      return hvo.value() - priv::point_hv(o1, m_ref);
+    return m_value(s1.objective_vector().data(), s2.objective_vector().data());
+  }
+
+  /**
+   * @brief Batch version of the function call operator. Evaluates the indicator
+   *        for a solution against every solution of a range (e.g. of a population).
+   *
+   * @tparam S The type used to store an genetic algorithm (IBEA) solution
+   * @tparam It The type for the iterators of the range of solutions.
+   * @tparam Out The type for the output iterator of the values.
+   * @param s1 The solution to be evaluated (first argument of the indicator).
+   * @param first The begining of the range of solutions (second argument of the indicator).
+   * @param last The end of the range of solutions.
+   * @param out The output iterator receiving the values, in the order of the range.
+   */
+  template <typename S, typename It, typename Out>
+  void operator()(S const &s1, It first, It last, Out out) const {
+    auto const *o1 = s1.objective_vector().data();
+    for (; first != last; ++first, ++out) {
+      *out = m_value(o1, first->objective_vector().data());
+    }
+  }
+
+ private:
+  /// Indicator value of two objective vectors (dispatched on the number of objectives)
+  [[nodiscard]] double m_value(double const *o1, double const *o2) const {
+    auto const *ref = m_ref.data();
+    switch (m_ref.size()) {
+      case 2:
+        return priv::pair_hv_difference<2>(o1, o2, ref);
+      case 3:
+        return priv::pair_hv_difference<3>(o1, o2, ref);
+      case 5:
+        return priv::pair_hv_difference<5>(o1, o2, ref);
+      case 7:
+        return priv::pair_hv_difference<7>(o1, o2, ref);
+      default:
+        return priv::pair_hv_difference<0>(o1, o2, ref, m_ref.size());
     }
   }
 };
@@ -109,19 +161,21 @@ struct n_point_crossover {
   double m_crossover_probability;
   RNG m_rng;
   std::uniform_real_distribution<double> m_distrib;
+  std::uniform_int_distribution<std::size_t> m_point;
 
   /**
    * @brief Construct a new n_point_crosover object.
    *
    * @param crossover_points Number of crossover points considered by this operator.
    * @param crossover_probability Crossover probability considered by this operator.
-   * @param rng The random number generator object instance.
+   * @param rng The random number generator object instance (copied, e.g. a stream of its
+   *        own split with xoshiro256ss::jump).
    */
   constexpr n_point_crossover(std::size_t const crossover_points,
-                              double const crossover_probability, RNG &rng)
+                              double const crossover_probability, RNG rng)
       : m_crossover_points(crossover_points)
       , m_crossover_probability(crossover_probability)
-      , m_rng(rng)
+      , m_rng(std::move(rng))
       , m_distrib(0.0, 1.0) {}
 
   /**
@@ -133,17 +187,50 @@ struct n_point_crossover {
    */
   template <typename S = priv::gasolution>
   void operator()(S &s1, S &s2) noexcept {
+    APMNKL_PROFILE_SCOPE(crossover);
     if (m_distrib(m_rng) < m_crossover_probability) {
       std::size_t p1 = 0, p2 = 0;
       for (std::size_t i = 0; i < m_crossover_points; ++i, p1 = p2) {
-        std::uniform_int_distribution<std::size_t> randint(p1, s1.size() - 1);
-        p2 = randint(m_rng);
-        for (std::size_t j = p1; j < p2; ++j) {
-          std::swap(s1[j], s2[j]);
-        };
+        using param_type = typename std::uniform_int_distribution<std::size_t>::param_type;
+        p2 = m_point(m_rng, param_type(p1, s1.size() - 1));
+        s1.decision_vector().swap_range(s2.decision_vector(), p1, p2);
       }
     }
   }
+
+  /**
+   * @brief Get a copy of the operator drawing from an independent stream, its generator
+   *        seeded with a value (e.g. one copy per thread of the parallel variation of IBEA).
+   *
+   * @param seed The seed of the generator of the copy.
+   * @return n_point_crossover The copy of the operator.
+   */
+  [[nodiscard]] n_point_crossover split(std::uint64_t const seed) const {
+    auto copy = *this;
+    copy.m_rng.seed(static_cast<typename RNG::result_type>(seed));
+    copy.m_distrib.reset();
+    return copy;
+  }
+
+  /**
+   * @brief Save the state of the operator (its generator) into a checkpoint.
+   *
+   * @param writer The checkpoint writer.
+   */
+  void save(priv::checkpoint_writer &writer) const {
+    writer.write_state(m_rng);
+    writer.write_state(m_distrib);
+  }
+
+  /**
+   * @brief Load the state of the operator from a checkpoint.
+   *
+   * @param reader The checkpoint reader.
+   */
+  void load(priv::checkpoint_reader &reader) {
+    reader.read_state(m_rng);
+    reader.read_state(m_distrib);
+  }
 };
 
 /// Helper `using` to avoid typing full class name.
@@ -159,34 +246,70 @@ template <typename RNG>
 struct uniform_crossover {
   double m_crossover_probability;
   RNG m_rng;
-  std::bernoulli_distribution m_distrib;
 
   /**
    * @brief Construct a new uniform_crossover object.
    *
    * @param crossover_probability Crossover probability considered in this operator.
-   * @param rng The random number generator object instance.
+   * @param rng The random number generator object instance (copied, e.g. a stream of its
+   *        own split with xoshiro256ss::jump).
    */
-  constexpr uniform_crossover(double crossover_probability, RNG &rng)
+  constexpr uniform_crossover(double crossover_probability, RNG rng)
       : m_crossover_probability(crossover_probability)
-      , m_rng(rng)
-      , m_distrib() {}
+      , m_rng(std::move(rng)) {}
 
   /**
    * @brief Function call operator overload. Implements the
-   *        crossover operator functionality.
+   *        crossover operator functionality. Every bit is swapped with probability 1/2,
+   *        i.e. the mask is filled with 64 random bits per draw.
    *
    * @tparam S The type used to store an genetic algorithm (IBEA) solution
    * @param s1 A solution to be recombinated.
    * @param s2 A solution to be recombinated.
    */
   template <typename S = priv::gasolution>
-  constexpr void operator()(S &s1, S &s2) noexcept {
-    for (std::size_t i = 0; i < s1.size(); ++i) {
-      if (m_distrib(m_rng)) {
-        std::swap(s1[i], s2[i]);
-      }
+  void operator()(S &s1, S &s2) noexcept {
+    APMNKL_PROFILE_SCOPE(crossover);
+    decision_vector mask(s1.size());
+    auto *words = mask.data();
+    for (std::size_t w = 0; w < mask.word_count(); ++w) {
+      words[w] = priv::random_bits(m_rng);
+    }
+    if (auto const bits = mask.size() % decision_vector::word_bits; bits != 0) {
+      words[mask.word_count() - 1] &= (decision_vector::word_type(1) << bits) - 1;
     }
+    s1.decision_vector().swap_masked(s2.decision_vector(), mask);
+  }
+
+  /**
+   * @brief Get a copy of the operator drawing from an independent stream, its generator
+   *        seeded with a value (e.g. one copy per thread of the parallel variation of IBEA).
+   *
+   * @param seed The seed of the generator of the copy.
+   * @return uniform_crossover The copy of the operator.
+   */
+  [[nodiscard]] uniform_crossover split(std::uint64_t const seed) const {
+    auto copy = *this;
+    copy.m_rng.seed(static_cast<typename RNG::result_type>(seed));
+    return copy;
+  }
+
+  /**
+   * @brief Save the state of the operator (its generator) into a checkpoint.
+   *
+   * @param writer The checkpoint writer.
+   */
+  void save(priv::checkpoint_writer &writer) const {
+    writer.write_state(m_rng);
+  }
+
+  /**
+   * @brief Load the state of the operator from a checkpoint.
+   *
+   * @param reader The checkpoint reader.
+   */
+  void load(priv::checkpoint_reader &reader) {
+    reader.read_state(m_rng);
   }
 };
 
@@ -207,34 +330,82 @@ template <typename RNG>
 struct uniform_mutation {
   double m_mutation_probability;
   RNG m_rng;
-  std::uniform_real_distribution<double> m_distrib;
+  // gaps between two flipped bits (failures before a success), defined for 0 < p < 1
+  std::geometric_distribution<std::size_t> m_distrib;
 
   /**
    * @brief Construct a new uniform_mutation object.
    *
    * @param mutation_probability Mutation probability considered in this operator.
-   * @param rng The random number generator object instance.
+   * @param rng The random number generator object instance (copied, e.g. a stream of its
+   *        own split with xoshiro256ss::jump).
    */
-  constexpr uniform_mutation(double const mutation_probability, RNG &rng)
+  constexpr uniform_mutation(double const mutation_probability, RNG rng)
       : m_mutation_probability(mutation_probability)
-      , m_rng(rng)
-      , m_distrib(0.0, 1.0) {}
+      , m_rng(std::move(rng))
+      , m_distrib(mutation_probability > 0 && mutation_probability < 1 ? mutation_probability
+                                                                       : 0.5) {}
 
   /**
    * @brief Function call operator overload. Implements the
-   *        crossover operator functionality.
+   *        crossover operator functionality. Every bit is flipped with the mutation
+   *        probability, skipping the gaps between the flipped bits (geometric variates), so
+   *        a mutation draws once per flipped bit rather than once per bit.
    *
    * @tparam S The type used to store an genetic algorithm (IBEA) solution
    * @param s A solution to be mutated.
    */
   template <typename S = priv::gasolution>
-  constexpr void operator()(S &s) noexcept {
-    for (std::size_t i = 0; i < s.size(); ++i) {
-      if (m_distrib(m_rng) < m_mutation_probability) {
-        s[i] = !s[i];
+  void operator()(S &s) noexcept {
+    APMNKL_PROFILE_SCOPE(mutation);
+    auto &decision = s.decision_vector();
+    if (m_mutation_probability >= 1) {
+      decision.flip(decision_vector(s.size(), true));
+    } else if (m_mutation_probability > 0) {
+      for (std::size_t i = 0;; ++i) {
+        auto const gap = m_distrib(m_rng);
+        if (gap >= s.size() - i) {
+          break;
+        }
+        i += gap;
+        decision.flip(i);
       }
     }
   }
+
+  /**
+   * @brief Get a copy of the operator drawing from an independent stream, its generator
+   *        seeded with a value (e.g. one copy per thread of the parallel variation of IBEA).
+   *
+   * @param seed The seed of the generator of the copy.
+   * @return uniform_mutation The copy of the operator.
+   */
+  [[nodiscard]] uniform_mutation split(std::uint64_t const seed) const {
+    auto copy = *this;
+    copy.m_rng.seed(static_cast<typename RNG::result_type>(seed));
+    copy.m_distrib.reset();
+    return copy;
+  }
+
+  /**
+   * @brief Save the state of the operator (its generator) into a checkpoint.
+   *
+   * @param writer The checkpoint writer.
+   */
+  void save(priv::checkpoint_writer &writer) const {
+    writer.write_state(m_rng);
+    writer.write_state(m_distrib);
+  }
+
+  /**
+   * @brief Load the state of the operator from a checkpoint.
+   *
+   * @param reader The checkpoint reader.
+   */
+  void load(priv::checkpoint_reader &reader) {
+    reader.read_state(m_rng);
+    reader.read_state(m_distrib);
+  }
 };
 
 /// Helper `using` to avoid typing full class name.
@@ -260,26 +431,29 @@ struct k_way_tournament {
    *
    * @param tournament_size The size of the tournament (K)
    * @param matting_pool_size The the maximum number of individuals allowed in the matting pool.
-   * @param rng The random number generator objects.
+   * @param rng The random number generator object instance (copied, e.g. a stream of its
+   *        own split with xoshiro256ss::jump).
    */
   constexpr k_way_tournament(std::size_t const tournament_size, std::size_t const matting_pool_size,
-                             RNG &rng)
+                             RNG rng)
       : m_tournament_size(tournament_size)
       , m_matting_pool_size(matting_pool_size)
-      , m_rng(rng){};
+      , m_rng(std::move(rng)){};
 
   /**
    * @brief Function call operator overload. Implements the
    *        selection operator functionality.
    *
-   * @tparam S The type used to store an genetic algorithm (IBEA) solution
+   * @tparam P The type used to store the population (e.g. a priv::population, or a vector
+   *         of genetic algorithm solutions)
    * @param population The population from which the individuals will be selected.
-   * @return std::vector<S> The matting pool obtain as a result from the selection
-   *                        of the individuals of the population.
+   * @return std::vector<std::size_t> The matting pool obtain as a result from the selection
+   *                                  of the individuals of the population (their indices).
    */
-  template <typename S = priv::gasolution>
-  [[nodiscard]] std::vector<S> operator()(std::vector<S> const &population) noexcept {
-    std::vector<S> matting_pool;
+  template <typename P = priv::population>
+  [[nodiscard]] std::vector<std::size_t> operator()(P const &population) {
+    APMNKL_PROFILE_SCOPE(selection);
+    std::vector<std::size_t> matting_pool;
     matting_pool.reserve(m_matting_pool_size);
     std::uniform_int_distribution<std::size_t> distrib(0, population.size() - 1);
 
@@ -289,10 +463,28 @@ struct k_way_tournament {
         auto other = distrib(m_rng);
         best = population[other].fitness() > population[best].fitness() ? other : best;
       }
-      matting_pool.push_back(population[best]);
+      matting_pool.push_back(best);
     }
     return matting_pool;
   }
+
+  /**
+   * @brief Save the state of the operator (its generator) into a checkpoint.
+   *
+   * @param writer The checkpoint writer.
+   */
+  void save(priv::checkpoint_writer &writer) const {
+    writer.write_state(m_rng);
+  }
+
+  /**
+   * @brief Load the state of the operator from a checkpoint.
+   *
+   * @param reader The checkpoint reader.
+   */
+  void load(priv::checkpoint_reader &reader) {
+    reader.read_state(m_rng);
+  }
 };
 
 /// Helper `using` to avoid typing full class name.
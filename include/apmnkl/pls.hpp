@@ -13,10 +13,26 @@
 #ifndef PLS_HPP
 #define PLS_HPP
 
-#include <csignal>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
 #include <iomanip>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "utils/anytime.hpp"
+#include "utils/budget.hpp"
+#include "utils/cache.hpp"
+#include "utils/checkpoint.hpp"
 #include "utils/solution.hpp"
+#include "utils/thread_pool.hpp"
 #include "utils/utils.hpp"
 #include "utils/wfg.hpp"
 
@@ -29,19 +45,66 @@ class pls {
   using hv_type = typename objv_type::value_type;
   using solution_type = typename priv::solution;
 
+ private:
+  std::shared_ptr<priv::RMNKEval const> m_evaluator;
+
  public:
-  priv::RMNKEval eval;
+  /// The (read-only) evaluator of the instance, possibly shared with other runs
+  priv::RMNKEval const &eval;
 
  private:
   std::mt19937 m_generator;
 
-  priv::hvobj<hv_type> m_hvo;
-  std::vector<std::tuple<std::size_t, hv_type>> m_anytime;
+  priv::anytime_recorder<hv_type> m_anytime;
+  priv::time_budget m_budget;
+
+  priv::archive<solution_type> m_solutions;
+  priv::archive<solution_type> m_non_visited_solutions;
+
+  /// Neighborhood of a solution being explored, evaluated one batch of moves at a time
+  struct neighborhood_scan {
+    priv::neighborhood_sampler sampler;
+    std::vector<priv::NeighborMove> moves;
+    priv::NeighborBatch neighbors;
+    // the neighbors left for the second pass of the both acceptance criterion (their moves
+    // and objective vectors, row-major), unless a dominating neighbor was accepted
+    bool use_remaining = true;
+    std::vector<priv::NeighborMove> remaining_moves;
+    std::vector<double> remaining_objectives;
+    priv::NeighborBatch remaining;
+    // the neighbors of the batch found in the evaluation cache, and the scratch decision and
+    // objective vectors of a neighbor looked up
+    std::vector<char> cached;
+    decv_type decision;
+    std::vector<double> objective;
+  };
+
+  neighborhood_scan m_scan;
+
+  // cache of the neighbors offered to the archive (shared by the threads), and its hits
+  evaluation_cache_policy m_cache_policy;
+  priv::evaluation_cache m_cache;
+  std::size_t m_cache_hits = 0;
+
+  std::size_t m_threads = 1;
+  std::unique_ptr<priv::thread_pool> m_pool;
 
-  std::vector<solution_type> m_solutions;
-  std::vector<solution_type> m_non_visited_solutions;
+  // state of a resumable run: the evaluations performed (when it stopped), and whether the
+  // next run resumes it (loaded from a checkpoint)
+  std::size_t m_evaluation = 0;
+  bool m_resumable = false;
+  bool m_resumed = false;
+
+  /// Unvisited solutions owned by a thread of the parallel mode (stolen by the others)
+  struct work_queue {
+    std::mutex mutex;
+    std::deque<solution_type> solutions;
+  };
 
  public:
+  /// The type for the anytime data rows <evaluation, hypervolume, elapsed>
+  using anytime_row_type = priv::anytime_recorder<hv_type>::row_type;
+
   /** Acceptance criterion:
    *  - 0 -> accept every non-dominated neighbor (non_dominating).
    *  - 1 -> accept only neighbors that dominate current solution (dominating).
@@ -63,6 +126,20 @@ class pls {
   /// Helper `using` to avoid typing too much
   using pne = pls_neighborhood_exploration;
 
+  /** Neighborhood of a solution:
+   *  - 0 -> the solutions flipping one bit (flip).
+   *  - 1 -> the solutions swapping two different bits (swap).
+   *  - 2 -> the solutions flipping one bit or swapping two different bits (flip_swap).
+   */
+  enum class pls_neighborhood { flip, swap, flip_swap };
+
+  /// Helper `using` to avoid typing too much
+  using pnh = pls_neighborhood;
+
+ private:
+  pnh m_neighborhood = pnh::flip;
+
+ public:
   /**
    * @brief Construct a new pls object.
    *
@@ -77,9 +154,8 @@ class pls {
 
   template <typename Str = std::string, typename Ref = objv_type>
   pls(Str &&instance, unsigned int seed, Ref &&ref)
-      : eval(std::forward<Str>(instance).c_str())
-      , m_generator(seed)
-      , m_hvo(std::forward<Ref>(ref)) {}
+      : pls(std::make_shared<priv::RMNKEval const>(std::forward<Str>(instance).c_str()), seed,
+              std::forward<Ref>(ref)) {}
 
   /**
    * @brief Construct a new pls object.
@@ -91,9 +167,37 @@ class pls {
    */
   template <typename Str = std::string>
   pls(Str &&instance, unsigned int seed)
-      : eval(std::forward<Str>(instance).c_str())
+      : pls(std::make_shared<priv::RMNKEval const>(std::forward<Str>(instance).c_str()), seed) {}
+
+  /**
+   * @brief Construct a new pls object sharing the (read-only) evaluator of an instance,
+   *        e.g. with other runs of the algorithm executed concurrently.
+   *
+   * @tparam Ref the type used to store the reference point of the hvobj obj
+   * @param evaluator The evaluator of the "rmnk" instance to be used.
+   * @param seed The seed used by the pseudo random number generator used in PLS
+   * @param ref The reference point considered by hypervolume indicator whilst running the
+   * algorithms (anytime measure)
+   */
+  template <typename Ref = objv_type>
+  pls(std::shared_ptr<priv::RMNKEval const> evaluator, unsigned int seed, Ref &&ref)
+      : m_evaluator(std::move(evaluator))
+      , eval(*m_evaluator)
       , m_generator(seed)
-      , m_hvo(objv_type(eval.getM(), 0.0)) {}
+      , m_anytime(std::forward<Ref>(ref)) {}
+
+  /**
+   * @brief Construct a new pls object sharing the (read-only) evaluator of an instance,
+   *        e.g. with other runs of the algorithm executed concurrently.
+   *
+   * @param evaluator The evaluator of the "rmnk" instance to be used.
+   * @param seed The seed used by the pseudo random number generator used in PLS
+   */
+  pls(std::shared_ptr<priv::RMNKEval const> evaluator, unsigned int seed)
+      : m_evaluator(std::move(evaluator))
+      , eval(*m_evaluator)
+      , m_generator(seed)
+      , m_anytime(objv_type(eval.getM(), 0.0)) {}
 
   /**
    * @brief Construct a new pls object
@@ -127,7 +231,7 @@ class pls {
    *         visited solutions produced by the PLS algorithm.
    */
   auto const &solutions() const {
-    return m_solutions;
+    return m_solutions.solutions();
   }
 
   /**
@@ -138,22 +242,184 @@ class pls {
    *         non visited solutions produced by PLS algorithm.
    */
   auto const &non_visited_solutions() const {
-    return m_non_visited_solutions;
+    return m_non_visited_solutions.solutions();
   }
 
   /**
    * @brief Getter for the anytime data produced by this algorithm.
    *
-   * @return auto const& Read-Only reference to a vector of pairs <evaluation,
-   *         hypervolume> obtained in the run of the PLS algorithm.
+   * @return auto const& Read-Only reference to a vector of rows <evaluation,
+   *         hypervolume, elapsed> obtained in the run of the PLS algorithm.
    */
   auto const &anytime() const {
-    return m_anytime;
+    return m_anytime.rows();
+  }
+
+  /**
+   * @brief Set the policy followed when recording the anytime data (before running
+   *        the algorithm).
+   *
+   * @param policy The anytime recording policy.
+   */
+  void set_anytime_policy(anytime_policy const &policy) {
+    m_anytime.set_policy(policy);
+  }
+
+  /**
+   * @brief Set the sink receiving the anytime data rows while the algorithm runs (before
+   *        running the algorithm). By default the rows are kept in memory (see anytime()).
+   *
+   * @param sink The anytime data sink, or nullptr to keep the rows in memory.
+   */
+  void set_anytime_sink(std::shared_ptr<anytime_sink<anytime_row_type>> sink) {
+    m_anytime.set_sink(std::move(sink));
+  }
+
+  /**
+   * @brief Set a wall-clock time limit of the runs (stopping criterion, along with the
+   *        maximum number of evaluations and a stop request, see stop_on_signals).
+   *
+   * @param limit The time limit of a run (zero for no limit).
+   * @param check_interval The number of evaluations between two checks of the clock.
+   */
+  void set_time_limit(std::chrono::nanoseconds const limit, std::size_t const check_interval) {
+    m_budget.set(limit, check_interval);
+  }
+
+  /**
+   * @brief Set the number of threads exploring the neighborhoods of the unvisited solutions.
+   *        With a single thread (the default) the run only depends on the seed, otherwise it
+   *        also depends on the scheduling of the threads.
+   *
+   * @param threads The number of threads (0 to use one per hardware thread).
+   */
+  void set_threads(std::size_t const threads) {
+    m_threads = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    m_pool = m_threads > 1 ? std::make_unique<priv::thread_pool>(m_threads - 1) : nullptr;
+  }
+
+  /**
+   * @brief Set the cache of the neighbors offered to the archive (before running the
+   *        algorithm). A neighbor found in the cache was already offered to the archive, which
+   *        rejects it again (the archive only improves), so its acceptance is skipped. The
+   *        neighbors are still evaluated in batches (cheaper than looking them up one at a
+   *        time), so the cache saves the archive queries, and the evaluations too if the hits
+   *        are not counted as evaluations (otherwise the run is the same as without the cache).
+   *        The threads share the cache (looked up without a lock).
+   *
+   * @param policy The evaluation cache policy (the number of slots, and whether the hits are
+   *               counted as evaluations).
+   */
+  void set_evaluation_cache(evaluation_cache_policy const &policy) {
+    m_cache_policy = policy;
+  }
+
+  /**
+   * @brief Get the number of neighbors of the last run found in the evaluation cache (a
+   *        resumed run included).
+   *
+   * @return std::size_t The number of cache hits.
+   */
+  [[nodiscard]] std::size_t cache_hits() const noexcept {
+    return m_cache_hits;
+  }
+
+  /**
+   * @brief Set the neighborhood of the solutions explored (before running the algorithm). The
+   *        flip neighborhood (the default) is explored in the order of the bits, while the
+   *        (O(N^2)) swap and flip_swap neighborhoods are explored in a random order, drawn
+   *        lazily, one batch of N neighbors at a time: the first improvement exploration only
+   *        evaluates the batches up to the first accepted neighbor. The neighbors are
+   *        evaluated incrementally (a swap only recomputes the contributions linked to its
+   *        two bits).
+   *
+   * @param neighborhood The neighborhood.
+   */
+  void set_neighborhood(pnh const neighborhood) {
+    m_neighborhood = neighborhood;
+  }
+
+  /**
+   * @brief Keep the runs resumable (before running the algorithm): a run stopped by the time
+   *        limit (or a stop request) does not record the rows of its last evaluation, as the
+   *        resumed run records them (see save_checkpoint).
+   *
+   * @param resumable Keep the runs resumable.
+   */
+  void set_resumable(bool const resumable) {
+    m_resumable = resumable;
+  }
+
+  /**
+   * @brief Check if the last run was stopped (by the time limit or a stop request) before
+   *        reaching its end.
+   *
+   * @return true If the run was stopped.
+   */
+  [[nodiscard]] bool stopped() const noexcept {
+    return m_budget.expired();
+  }
+
+  /**
+   * @brief Get the number of evaluations performed by the last run (a resumed run included,
+   *        they count from the start of the run).
+   *
+   * @return std::size_t The number of evaluations.
+   */
+  [[nodiscard]] std::size_t evaluations() const noexcept {
+    return m_evaluation;
+  }
+
+  /**
+   * @brief Save the state of a resumable run that was stopped into a (binary) checkpoint: the
+   *        archive, the unvisited solutions, the generator, the anytime data recorder, the
+   *        evaluation cache and the evaluations performed. A run resumed from the checkpoint
+   *        (with the same options) records the very same anytime data as a run that was not
+   *        stopped (with a single thread).
+   *
+   * @param os The output stream (in binary mode) where the checkpoint is written.
+   * @throws std::logic_error If the run is not resumable or was not stopped.
+   */
+  void save_checkpoint(std::ostream &os) const {
+    if (!m_resumable || !stopped()) {
+      throw std::logic_error("only a resumable run that was stopped can be checkpointed");
+    }
+    priv::checkpoint_writer writer(os);
+    priv::write_checkpoint_header(writer, "PLS", eval);
+    writer.write_state(m_generator);
+    writer.write(m_solutions);
+    writer.write(m_non_visited_solutions);
+    writer.write(m_anytime);
+    writer.write_size(m_evaluation);
+    writer.write(m_cache);
+    writer.write_size(m_cache_hits);
+  }
+
+  /**
+   * @brief Load the state of a run from a checkpoint, which the next run resumes.
+   *
+   * @param is The input stream (in binary mode) holding the checkpoint.
+   * @throws std::runtime_error If the checkpoint is invalid, or does not hold a run of PLS
+   *         on the instance.
+   */
+  void load_checkpoint(std::istream &is) {
+    priv::checkpoint_reader reader(is);
+    priv::read_checkpoint_header(reader, "PLS", eval);
+    reader.read_state(m_generator);
+    reader.read(m_solutions);
+    reader.read(m_non_visited_solutions);
+    reader.read(m_anytime);
+    m_evaluation = reader.read_size();
+    reader.read(m_cache);
+    m_cache_hits = reader.read_size();
+    m_resumed = true;
   }
 
   /**
    * @brief PLS implementation runner. This effectively starts the algorithm and runs it
-   * until the maximum number of evaluations has been reached.
+   * until the maximum number of evaluations has been reached (or the time limit, or a stop
+   * request). The time limit is checked between the explorations of two neighborhoods.
+   * The run loaded from a checkpoint is resumed.
    *
    * @param maxeval The maximum number of evaluations performed by PLS (stopping criterion)
    * @param acceptance_criterion The PLS algorithm solution acceptance criterion
@@ -161,14 +427,29 @@ class pls {
    */
   void run(std::size_t maxeval, pac const acceptance_criterion,
            pne const neighborhood_exploration) {
-    auto rand_solution = solution_type::random_solution(eval, m_generator);
-    m_hvo.insert(rand_solution.objective_vector());
+    std::size_t evaluation = 0;
+    m_anytime.start();
+    m_budget.start();
 
-    add_non_dominated(m_non_visited_solutions, std::move(rand_solution));
-    m_solutions = m_non_visited_solutions;
+    if (std::exchange(m_resumed, false)) {
+      evaluation = m_evaluation;
+    } else {
+      auto rand_solution = solution_type::random_solution(eval, m_generator);
+      m_anytime.insert(rand_solution.objective_vector(), evaluation);
+      m_cache = m_cache_policy.slots != 0
+                    ? priv::evaluation_cache(m_cache_policy.slots, eval.getN(), eval.getM())
+                    : priv::evaluation_cache();
+      m_cache_hits = 0;
+      if (m_cache.enabled()) {
+        m_cache.insert(rand_solution.decision_vector(), rand_solution.objective_vector());
+      }
 
-    std::size_t evaluation = 0;
-    m_anytime.push_back({evaluation, m_hvo.value()});
+      add_non_dominated(m_non_visited_solutions, std::move(rand_solution));
+      m_solutions = m_non_visited_solutions;
+    }
+
+    m_scan.sampler = priv::neighborhood_sampler(eval.getN(), m_neighborhood != pnh::swap,
+                                                m_neighborhood != pnh::flip);
 
 #define RUNLOOP(FIRSTIMPROV)                                         \
   switch (acceptance_criterion) {                                    \
@@ -195,12 +476,19 @@ class pls {
     } else {
       throw("Unknown value for neighborhood exploration");
     }
+    m_evaluation = evaluation;
+    if (!m_resumable || !stopped()) {
+      m_anytime.finish(evaluation);
+    }
+    m_anytime.flush();
   }
 
  private:
   /**
    * @brief Helper function that provides the implementation of
    *        multiple acceptance/exploration criterion exploration methods.
+   *        The neighborhood of a solution is evaluated in batches (see m_explore),
+   *        and a neighbor is only built as a solution once it can be accepted.
    *
    * @tparam FirstImprov Boolean template parameter indicating if the first
    *         improvement technique should be used
@@ -211,82 +499,379 @@ class pls {
    */
   template <bool FirstImprov, pac Acceptance>
   void m_loop(size_t &evaluation, size_t maxeval) {
-    while (evaluation < maxeval && !m_non_visited_solutions.empty()) {
+    if (m_threads > 1) {
+      m_parallel_loop<FirstImprov, Acceptance>(evaluation, maxeval);
+      return;
+    }
+
+    while (evaluation < maxeval && !m_non_visited_solutions.empty() &&
+           !m_budget.expired(evaluation)) {
       std::uniform_int_distribution<std::size_t> distrib(0, m_non_visited_solutions.size() - 1);
       std::size_t index = distrib(m_generator);
 
-      auto original = std::move(m_non_visited_solutions[index]);
-      m_non_visited_solutions[index] = std::move(m_non_visited_solutions.back());
-      m_non_visited_solutions.pop_back();
-
-      if constexpr (Acceptance == pac::non_dominating) {
-        for (size_t i = 0; i < original.decision_vector().size() && evaluation < maxeval; ++i) {
-          auto decv = original.decision_vector();
-          decv[i] = !decv[i];
-          auto solution = solution_type(eval, std::move(decv));
-          ++evaluation;
-          if (add_non_dominated(m_solutions, solution)) {
-            m_hvo.insert(solution.objective_vector());
-            add_non_dominated(m_non_visited_solutions, std::move(solution));
-            m_anytime.push_back({evaluation, m_hvo.value()});
-            if constexpr (FirstImprov) {
-              break;
-            }
+      auto original = m_non_visited_solutions.extract(index);
+
+      m_explore<FirstImprov, Acceptance>(
+          original, m_scan, m_generator, maxeval,
+          [&evaluation](auto &&explore) { explore(evaluation); },
+          [this](auto &&solution) {
+            add_non_dominated(m_non_visited_solutions, std::forward<decltype(solution)>(solution));
+          });
+    }
+  }
+
+  /**
+   * @brief Parallel version of m_loop. Every thread explores the neighborhoods of the
+   *        unvisited solutions of its own queue (stealing from the queues of the other
+   *        threads once it is empty), while the neighbors are merged into the archive one
+   *        batch at a time. The evaluations are counted (and the anytime data recorded) in
+   *        the merge, so the budget is respected exactly. Every thread draws the order of
+   *        its neighborhoods from its own generator (seeded by the generator of the run).
+   *        The archive is not concurrent: its queries and updates (and the counting of the
+   *        evaluations) are serialized by a single merge lock, so the threads only scale as
+   *        far as the evaluation of the batches (outside the lock) dominates their merges,
+   *        e.g. for large N and K, and wait on the lock with many threads or large archives.
+   *
+   * @tparam FirstImprov Boolean template parameter indicating if the first
+   *         improvement technique should be used
+   * @tparam Acceptance Neighborhood exporation criterion type indication the
+   *         exploration method to be used.
+   * @param evaluation The current evaluation number.
+   * @param maxeval The maximum number of evaluations.
+   */
+  template <bool FirstImprov, pac Acceptance>
+  void m_parallel_loop(size_t &evaluation, size_t maxeval) {
+    std::vector<work_queue> queues(m_threads);
+    std::atomic<std::size_t> counter(evaluation);
+    std::atomic<std::size_t> pending(0);
+    std::atomic<bool> stopped(m_budget.expired(evaluation));
+    std::mutex merge;
+
+    for (std::size_t i = 0; !m_non_visited_solutions.empty(); ++i) {
+      queues[i % queues.size()].solutions.push_back(
+          m_non_visited_solutions.extract(m_non_visited_solutions.size() - 1));
+      ++pending;
+    }
+    std::vector<std::mt19937::result_type> seeds(queues.size());
+    for (auto &seed : seeds) {
+      seed = m_generator();
+    }
+
+    auto worker = [&](std::size_t const id) {
+      neighborhood_scan scan;
+      scan.sampler = m_scan.sampler;
+      std::mt19937 generator(seeds[id]);
+      while (counter.load() < maxeval && !stopped.load()) {
+        auto original = m_take(queues, id);
+        if (!original) {
+          if (pending.load() == 0) {
+            return;
           }
+          std::this_thread::yield();
+          continue;
+        }
+
+        // the solution is skipped if it was dominated since it was queued
+        bool explore;
+        {
+          std::lock_guard<std::mutex> lock(merge);
+          explore = m_solutions.contains(*original);
+        }
+        if (explore) {
+          m_explore<FirstImprov, Acceptance>(
+              *original, scan, generator, maxeval,
+              [&](auto &&explore_batch) {
+                std::lock_guard<std::mutex> lock(merge);
+                auto count = counter.load();
+                explore_batch(count);
+                counter.store(count);
+                stopped.store(m_budget.expired(count));
+              },
+              [&](auto &&solution) {
+                std::lock_guard<std::mutex> push(queues[id].mutex);
+                queues[id].solutions.push_back(std::forward<decltype(solution)>(solution));
+                ++pending;
+              });
+        }
+        --pending;
+      }
+    };
+
+    std::vector<std::future<void>> workers;
+    for (std::size_t id = 1; id < queues.size(); ++id) {
+      workers.push_back(m_pool->submit([&worker, id]() { worker(id); }));
+    }
+    worker(0);
+    for (auto &w : workers) {
+      w.get();
+    }
+
+    evaluation = counter.load();
+    for (auto &queue : queues) {
+      for (auto &solution : queue.solutions) {
+        if (m_solutions.contains(solution)) {
+          add_non_dominated(m_non_visited_solutions, std::move(solution));
         }
-      } else if constexpr (Acceptance == pac::dominating) {
-        for (size_t i = 0; i < original.decision_vector().size() && evaluation < maxeval; ++i) {
-          auto decv = original.decision_vector();
-          decv[i] = !decv[i];
-          auto solution = solution_type(eval, std::move(decv));
-          ++evaluation;
-          if (solution.dominance(original) == priv::dominance_type::dominates &&
-              add_non_dominated(m_solutions, solution)) {
-            m_hvo.insert(solution.objective_vector());
-            add_non_dominated(m_non_visited_solutions, std::move(solution));
-            m_anytime.push_back({evaluation, m_hvo.value()});
-            if constexpr (FirstImprov) {
-              break;
-            }
+      }
+    }
+  }
+
+  /**
+   * @brief Take an unvisited solution from the queue of a thread (the last one queued),
+   *        or steal one from the queue of another thread (the first one queued).
+   *
+   * @param queues The queues of the threads.
+   * @param id The index of the thread.
+   * @return std::optional<solution_type> The solution, if every queue was not empty.
+   */
+  std::optional<solution_type> m_take(std::vector<work_queue> &queues, std::size_t const id) {
+    {
+      std::lock_guard<std::mutex> lock(queues[id].mutex);
+      if (!queues[id].solutions.empty()) {
+        auto solution = std::move(queues[id].solutions.back());
+        queues[id].solutions.pop_back();
+        return solution;
+      }
+    }
+    for (std::size_t k = 1; k < queues.size(); ++k) {
+      auto &victim = queues[(id + k) % queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.solutions.empty()) {
+        auto solution = std::move(victim.solutions.front());
+        victim.solutions.pop_front();
+        return solution;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Explore the neighborhood of a solution following the acceptance/exploration
+   *        criterion, adding the accepted neighbors to the archive. The moves to the
+   *        neighbors are drawn and evaluated one batch (of at most N moves) at a time, and
+   *        the exploration stops after the batch of its first accepted neighbor (first
+   *        improvement) or of the last evaluation.
+   *
+   * @tparam FirstImprov Boolean template parameter indicating if the first
+   *         improvement technique should be used
+   * @tparam Acceptance Neighborhood exporation criterion type indication the
+   *         exploration method to be used.
+   * @tparam RNG The type for the generator drawing the order of the neighbors.
+   * @tparam M The type for the callback merging a batch into the archive.
+   * @tparam V The type for the callback visiting the accepted neighbors.
+   * @param original The solution whose neighborhood is explored.
+   * @param scan The neighborhood explored (its sampler and batches).
+   * @param generator The generator drawing the order of the neighbors.
+   * @param maxeval The maximum number of evaluations.
+   * @param merge The callback running the exploration of an evaluated batch, given the
+   *        current evaluation number (e.g. under a lock).
+   * @param visit The callback receiving every accepted neighbor (to be visited later on).
+   */
+  template <bool FirstImprov, pac Acceptance, typename RNG, typename M, typename V>
+  void m_explore(solution_type const &original, neighborhood_scan &scan, RNG &generator,
+                 size_t maxeval, M &&merge, V &&visit) {
+    auto const &decision = original.decision_vector();
+    scan.sampler.restart();
+    scan.use_remaining = true;
+    scan.remaining_moves.clear();
+    scan.remaining_objectives.clear();
+
+    bool stop = false;
+    while (!stop && !scan.sampler.exhausted()) {
+      scan.sampler.draw(decision, generator, decision.size(), scan.moves);
+      eval.evalMoves(decision, original.objective_vector(), scan.moves, scan.neighbors);
+      if (m_cache.enabled()) {
+        m_lookup(original, scan);
+      }
+      merge([&](size_t &evaluation) {
+        stop = m_explore_batch<FirstImprov, Acceptance>(original, scan, evaluation, maxeval,
+                                                        visit);
+      });
+    }
+
+    if constexpr (Acceptance == pac::both) {
+      if (scan.use_remaining && !scan.remaining_moves.empty()) {
+        merge([&](size_t &evaluation) {
+          m_explore_remaining<FirstImprov>(original, scan, evaluation, visit);
+        });
+      }
+    }
+  }
+
+  /**
+   * @brief Explore an evaluated batch of the neighborhood of a solution (skipping the
+   *        neighbors found in the evaluation cache, already offered to the archive).
+   *
+   * @tparam FirstImprov Boolean template parameter indicating if the first
+   *         improvement technique should be used
+   * @tparam Acceptance Neighborhood exporation criterion type indication the
+   *         exploration method to be used.
+   * @tparam V The type for the callback visiting the accepted neighbors.
+   * @param original The solution whose neighborhood is explored.
+   * @param scan The neighborhood explored (holding the moves and the batch).
+   * @param evaluation The current evaluation number.
+   * @param maxeval The maximum number of evaluations.
+   * @param visit The callback receiving every accepted neighbor (to be visited later on).
+   * @return true If the exploration of the neighborhood stops (a neighbor was accepted with
+   *         first improvement, or the evaluations are exhausted).
+   */
+  template <bool FirstImprov, pac Acceptance, typename V>
+  bool m_explore_batch(solution_type const &original, neighborhood_scan &scan,
+                       size_t &evaluation, size_t maxeval, V &&visit) {
+    auto const &moves = scan.moves;
+    auto const &neighbors = scan.neighbors;
+    if constexpr (Acceptance == pac::non_dominating) {
+      for (size_t i = 0; i < neighbors.size && evaluation < maxeval; ++i) {
+        if (m_skip_cached(scan, i, evaluation)) {
+          continue;
+        }
+        ++evaluation;
+        m_offered(original, moves[i], neighbors, i, scan);
+        if (priv::is_dominated(m_solutions, neighbors, i)) {
+          continue;
+        }
+        auto solution = solution_type(original, moves[i], neighbors, i);
+        if (add_non_dominated(m_solutions, solution)) {
+          m_anytime.insert(solution.objective_vector(), evaluation);
+          visit(std::move(solution));
+          if constexpr (FirstImprov) {
+            return true;
           }
         }
-      } else if constexpr (Acceptance == pac::both) {
-        std::vector<std::pair<solution_type, size_t>> remaining;
-        remaining.reserve(original.decision_vector().size());
-        bool use_remaining = true;
-        for (size_t i = 0; i < original.decision_vector().size() && evaluation < maxeval; ++i) {
-          auto decv = original.decision_vector();
-          decv[i] = !decv[i];
-          auto solution = solution_type(eval, std::move(decv));
-          ++evaluation;
-          if (solution.dominance(original) == priv::dominance_type::dominates &&
-              add_non_dominated(m_solutions, solution)) {
-            use_remaining = false;
-            m_hvo.insert(solution.objective_vector());
-            add_non_dominated(m_non_visited_solutions, std::move(solution));
-            m_anytime.push_back({evaluation, m_hvo.value()});
-            if constexpr (FirstImprov) {
-              break;
-            }
-          } else if (use_remaining) {
-            remaining.emplace_back(std::move(solution), evaluation);
+      }
+    } else if constexpr (Acceptance == pac::dominating) {
+      for (size_t i = 0; i < neighbors.size && evaluation < maxeval; ++i) {
+        if (m_skip_cached(scan, i, evaluation)) {
+          continue;
+        }
+        ++evaluation;
+        if (priv::dominance(neighbors, i, original) != priv::dominance_type::dominates) {
+          continue;
+        }
+        m_offered(original, moves[i], neighbors, i, scan);
+        if (priv::is_dominated(m_solutions, neighbors, i)) {
+          continue;
+        }
+        auto solution = solution_type(original, moves[i], neighbors, i);
+        if (add_non_dominated(m_solutions, solution)) {
+          m_anytime.insert(solution.objective_vector(), evaluation);
+          visit(std::move(solution));
+          if constexpr (FirstImprov) {
+            return true;
           }
         }
-        if (use_remaining) {
-          for (auto &&[solution, iteration] : remaining) {
-            if (add_non_dominated(m_solutions, solution)) {
-              m_hvo.insert(solution.objective_vector());
-              add_non_dominated(m_non_visited_solutions, std::move(solution));
-              m_anytime.push_back({evaluation, m_hvo.value()});
-              if constexpr (FirstImprov) {
-                break;
-              }
-            }
+      }
+    } else if constexpr (Acceptance == pac::both) {
+      for (size_t i = 0; i < neighbors.size && evaluation < maxeval; ++i) {
+        if (m_skip_cached(scan, i, evaluation)) {
+          continue;
+        }
+        ++evaluation;
+        auto const dominates =
+            priv::dominance(neighbors, i, original) == priv::dominance_type::dominates;
+        if (dominates) {
+          m_offered(original, moves[i], neighbors, i, scan);
+        }
+        if (dominates && !priv::is_dominated(m_solutions, neighbors, i) &&
+            add_non_dominated(m_solutions, solution_type(original, moves[i], neighbors, i))) {
+          scan.use_remaining = false;
+          m_anytime.insert(m_solutions.back().objective_vector(), evaluation);
+          visit(m_solutions.back());
+          if constexpr (FirstImprov) {
+            return true;
           }
+        } else if (scan.use_remaining) {
+          scan.remaining_moves.push_back(moves[i]);
+          for (unsigned n = 0; n < eval.getM(); ++n) {
+            scan.remaining_objectives.push_back(neighbors.objective(n, i));
+          }
+        }
+      }
+    }
+    return evaluation >= maxeval;
+  }
+
+  /**
+   * @brief Second pass of the both acceptance criterion: accept the non-dominated neighbors
+   *        left (already evaluated) once no dominating neighbor was accepted.
+   *
+   * @tparam FirstImprov Boolean template parameter indicating if the first
+   *         improvement technique should be used
+   * @tparam V The type for the callback visiting the accepted neighbors.
+   * @param original The solution whose neighborhood is explored.
+   * @param scan The neighborhood explored (holding the neighbors left).
+   * @param evaluation The current evaluation number.
+   * @param visit The callback receiving every accepted neighbor (to be visited later on).
+   */
+  template <bool FirstImprov, typename V>
+  void m_explore_remaining(solution_type const &original, neighborhood_scan &scan,
+                           size_t const evaluation, V &&visit) {
+    auto const size = scan.remaining_moves.size();
+    auto const objectives = eval.getM();
+    auto &remaining = scan.remaining;
+    remaining.size = size;
+    remaining.objectives.resize(objectives * size);
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t n = 0; n < objectives; ++n) {
+        remaining.objectives[n * size + i] = scan.remaining_objectives[i * objectives + n];
+      }
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+      m_offered(original, scan.remaining_moves[i], remaining, i, scan);
+      if (!priv::is_dominated(m_solutions, remaining, i) &&
+          add_non_dominated(m_solutions,
+                            solution_type(original, scan.remaining_moves[i], remaining, i))) {
+        m_anytime.insert(m_solutions.back().objective_vector(), evaluation);
+        visit(m_solutions.back());
+        if constexpr (FirstImprov) {
+          break;
         }
       }
     }
   }
+
+  /// Build the decision vector of a neighbor (into the scratch decision vector of the scan)
+  decv_type const &m_neighbor_decision(solution_type const &original,
+                                       priv::NeighborMove const &move,
+                                       neighborhood_scan &scan) const {
+    scan.decision = original.decision_vector();
+    scan.decision.flip(move.first);
+    if (move.second != move.first) {
+      scan.decision.flip(move.second);
+    }
+    return scan.decision;
+  }
+
+  /// Flag the neighbors of the evaluated batch found in the evaluation cache
+  void m_lookup(solution_type const &original, neighborhood_scan &scan) const {
+    scan.cached.assign(scan.moves.size(), 0);
+    for (size_t i = 0; i < scan.moves.size(); ++i) {
+      scan.cached[i] =
+          m_cache.find(m_neighbor_decision(original, scan.moves[i], scan), scan.objective);
+    }
+  }
+
+  /// Skip a neighbor of the batch found in the evaluation cache, counting the hit (and the
+  /// evaluation, if the policy counts the hits as evaluations)
+  bool m_skip_cached(neighborhood_scan const &scan, size_t const i, size_t &evaluation) {
+    if (!m_cache.enabled() || !scan.cached[i]) {
+      return false;
+    }
+    ++m_cache_hits;
+    if (m_cache_policy.count_hits) {
+      ++evaluation;
+    }
+    return true;
+  }
+
+  /// Insert a neighbor offered to the archive into the evaluation cache (if enabled)
+  void m_offered(solution_type const &original, priv::NeighborMove const &move,
+                 priv::NeighborBatch const &batch, size_t const i, neighborhood_scan &scan) {
+    if (m_cache.enabled()) {
+      m_cache.insert(m_neighbor_decision(original, move, scan), priv::neighbor_point{batch, i});
+    }
+  }
 };
 }  // namespace apmnkl
 #endif  // PLS_HPP
@@ -0,0 +1,363 @@
+/**
+ * @file anytime.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Recording of the anytime (hypervolume) data produced by the search heuristics.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ANYTIME_HPP
+#define ANYTIME_HPP
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "checkpoint.hpp"
+#include "sink.hpp"
+#include "wfg.hpp"
+
+namespace apmnkl {
+
+/// Policy followed when recording the anytime data of a run
+struct anytime_policy {
+  /** Sampling of the anytime data:
+   *  - 0 -> record a row on every improvement of the approximation set (improvement).
+   *  - 1 -> record a row every `step` evaluations (fixed_grid).
+   *  - 2 -> record `step` (log-spaced) rows per decade of evaluations (log_grid).
+   */
+  enum class sampling { improvement, fixed_grid, log_grid };
+
+  sampling mode = sampling::improvement;
+
+  /// Evaluations between rows (fixed_grid) or rows per decade of evaluations (log_grid)
+  std::size_t step = 1;
+
+  /// Only log the inserted objective vectors (and their evaluation) during the run and
+  /// reconstruct the hypervolume data afterwards, in a separate pass.
+  bool deferred = false;
+
+  /// Approximation of the hypervolume (Monte Carlo samples of the box of the reference point,
+  /// none for the exact hypervolume, see hvobj::confidence for the precision of the estimate)
+  hv_approximation approximation;
+};
+
+namespace priv {
+
+/**
+ * @brief Recorder of the anytime data of a run, i.e. rows of <evaluation, keys..., hypervolume,
+ *        elapsed>, where elapsed is the wall-clock time (in nanoseconds) since the start of the
+ *        run at which the row was recorded.
+ *        Every objective vector accepted by a heuristic is inserted (in order) into the
+ *        hypervolume object, so rows taken at the same evaluation are identical regardless of
+ *        the sampling used or of the hypervolume data being computed during or after the run.
+ *        The rows are pushed to a sink as they are recorded (kept in memory by default).
+ *
+ * @tparam T The type for the hypervolume values.
+ * @tparam Keys The types of the extra columns of the rows (e.g. generation).
+ */
+template <typename T, typename... Keys>
+class anytime_recorder {
+ public:
+  using hv_type = T;
+  using ovec_type = std::vector<hv_type>;
+  using keys_type = std::tuple<Keys...>;
+  using row_type = std::tuple<std::size_t, Keys..., hv_type, std::uint64_t>;
+  using sink_type = anytime_sink<row_type>;
+
+  /**
+   * @brief Construct a new anytime recorder
+   *
+   * @param ref The reference point considered by the hypervolume indicator.
+   * @param policy The recording policy.
+   */
+  explicit anytime_recorder(ovec_type const &ref, anytime_policy const &policy = {})
+      : m_ref(ref)
+      , m_policy(policy)
+      , m_hvo(ref) {
+    m_reset();
+  }
+
+  /// Set the recording policy (discarding all the data recorded so far)
+  void set_policy(anytime_policy const &policy) {
+    m_policy = policy;
+    m_reset();
+  }
+
+  /**
+   * @brief Set the sink receiving the rows (before running the algorithm).
+   *
+   * @param sink The sink, or nullptr to keep the rows in memory (see rows()).
+   */
+  void set_sink(std::shared_ptr<sink_type> sink) {
+    m_sink = std::move(sink);
+  }
+
+  /// Record the start of a run (the origin of the elapsed time of the rows)
+  void start() {
+    m_start = clock::now();
+  }
+
+  /// Get the recording policy
+  [[nodiscard]] auto const &policy() const {
+    return m_policy;
+  }
+
+  /**
+   * @brief Record the insertion of an objective vector into the approximation set.
+   *
+   * @param v The objective vector inserted.
+   * @param evaluation The evaluation at which the objective vector was found.
+   * @param keys The extra columns of the row.
+   */
+  template <typename V>
+  void insert(V const &v, std::size_t const evaluation, Keys const... keys) {
+    if (m_policy.deferred) {
+      m_events.emplace_back(event::insert, evaluation, keys_type(keys...), m_elapsed());
+      m_points.insert(m_points.end(), v.begin(), v.end());
+    } else {
+      m_insert(v, evaluation, keys_type(keys...), m_elapsed());
+    }
+  }
+
+  /**
+   * @brief Record the end of a run, i.e. record the rows of the evaluation grid
+   *        up to (and including) the last evaluation.
+   *
+   * @param evaluation The last evaluation of the run.
+   * @param keys The extra columns of the rows.
+   */
+  void finish(std::size_t const evaluation, Keys const... keys) {
+    if (m_policy.deferred) {
+      m_events.emplace_back(event::finish, evaluation, keys_type(keys...), m_elapsed());
+    } else {
+      m_finish(evaluation, keys_type(keys...), m_elapsed());
+    }
+  }
+
+  /**
+   * @brief Record a row at a given evaluation regardless of the sampling
+   *        (unless the grid already holds a row for that evaluation).
+   *
+   * @param evaluation The evaluation of the row.
+   * @param keys The extra columns of the row.
+   */
+  void sample(std::size_t const evaluation, Keys const... keys) {
+    if (m_policy.deferred) {
+      m_events.emplace_back(event::sample, evaluation, keys_type(keys...), m_elapsed());
+    } else {
+      m_sample(evaluation, keys_type(keys...), m_elapsed());
+    }
+  }
+
+  /**
+   * @brief Reconstruct the hypervolume data from the log of a deferred run. This does
+   *        not depend on the search heuristic, so the log of several runs can be replayed
+   *        in parallel (one recorder per thread: the hypervolume of a recorder is computed in
+   *        its own workspaces, so a recorder is not to be shared by threads). No-op if there
+   *        is nothing to replay.
+   */
+  void replay() const {
+    if (m_events.empty()) {
+      return;
+    }
+    std::size_t point = 0;
+    for (auto const &[type, evaluation, keys, elapsed] : m_events) {
+      if (type == event::insert) {
+        auto const first = m_points.begin() + static_cast<std::ptrdiff_t>(point);
+        m_insert(ovec_type(first, first + static_cast<std::ptrdiff_t>(m_ref.size())), evaluation,
+                 keys, elapsed);
+        point += m_ref.size();
+      } else if (type == event::finish) {
+        m_finish(evaluation, keys, elapsed);
+      } else {
+        m_sample(evaluation, keys, elapsed);
+      }
+    }
+    m_events.clear();
+    m_points.clear();
+  }
+
+  /**
+   * @brief Write out the rows to the sink at the end of a run (replaying the log first if
+   *        the run was deferred). No-op if the rows are kept in memory.
+   */
+  void flush() const {
+    if (m_sink) {
+      replay();
+      m_sink->flush();
+    }
+  }
+
+  /**
+   * @brief Save the state of the recorder into a checkpoint (replaying the log first if the
+   *        run is deferred): the policy, the hypervolume object, the grid, the rows kept in
+   *        memory and the wall-clock time elapsed so far (the origin of the resumed rows).
+   *
+   * @param writer The checkpoint writer.
+   */
+  void save(checkpoint_writer &writer) const {
+    replay();
+    writer.write(std::make_tuple(m_policy.mode, m_policy.step, m_policy.deferred));
+    m_hvo.save(writer);
+    writer.write(m_rows.rows());
+    writer.write(std::make_tuple(m_last, m_keys, m_time, m_next, m_exponent, m_elapsed()));
+  }
+
+  /**
+   * @brief Load the state of the recorder from a checkpoint (the sink is kept).
+   *
+   * @param reader The checkpoint reader.
+   */
+  void load(checkpoint_reader &reader) {
+    m_reset();
+    std::tuple<anytime_policy::sampling, std::size_t, bool> policy;
+    reader.read(policy);
+    std::tie(m_policy.mode, m_policy.step, m_policy.deferred) = policy;
+    m_hvo.load(reader);
+    m_ref = m_hvo.reference();
+    m_policy.approximation = m_hvo.approximation();
+
+    std::vector<row_type> rows;
+    reader.read(rows);
+    for (auto const &row : rows) {
+      m_rows.push(row);
+    }
+    auto state = std::tie(m_last, m_keys, m_time, m_next, m_exponent, m_offset);
+    reader.read(state);
+  }
+
+  /// Get the rows recorded in memory, i.e. unless a sink was set (replaying the log first if
+  /// the run was deferred)
+  [[nodiscard]] auto const &rows() const {
+    replay();
+    return m_rows.rows();
+  }
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  enum class event { insert, finish, sample };
+
+  /// Wall-clock time (in nanoseconds) elapsed since the start of the run (including the time
+  /// elapsed before the run was checkpointed, if it was resumed)
+  [[nodiscard]] std::uint64_t m_elapsed() const {
+    return m_offset + static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - m_start).count());
+  }
+
+  /// Insert an objective vector, recording the grid rows of the evaluations before it
+  template <typename V>
+  void m_insert(V const &v, std::size_t const evaluation, keys_type const &keys,
+                std::uint64_t const elapsed) const {
+    m_time = elapsed;
+    m_grid(evaluation);
+    m_keys = keys;
+    m_hvo.insert(v);
+    if (m_policy.mode == anytime_policy::sampling::improvement) {
+      m_row(evaluation);
+    }
+  }
+
+  void m_finish(std::size_t const evaluation, keys_type const &keys,
+                std::uint64_t const elapsed) const {
+    m_time = elapsed;
+    m_grid(evaluation);
+    m_keys = keys;
+    m_grid(evaluation + 1);
+  }
+
+  void m_sample(std::size_t const evaluation, keys_type const &keys,
+                std::uint64_t const elapsed) const {
+    m_finish(evaluation, keys, elapsed);
+    if (m_policy.mode == anytime_policy::sampling::improvement || m_last != evaluation) {
+      m_row(evaluation);
+    }
+  }
+
+  /// Record the rows of the evaluation grid that precede a given evaluation
+  void m_grid(std::size_t const evaluation) const {
+    if (m_policy.mode == anytime_policy::sampling::improvement) {
+      return;
+    }
+    while (m_next < evaluation) {
+      m_row(m_next);
+      m_advance();
+    }
+  }
+
+  /// Move to the next evaluation of the grid
+  void m_advance() const {
+    if (m_policy.mode == anytime_policy::sampling::fixed_grid) {
+      m_next += m_policy.step;
+      return;
+    }
+    // log_grid: 0, then round(10^(j / step)) for j = 0, 1, ... (skipping repeated evaluations)
+    std::size_t next = m_next;
+    while (next <= m_next) {
+      auto const exponent = static_cast<double>(m_exponent++) / static_cast<double>(m_policy.step);
+      next = static_cast<std::size_t>(std::llround(std::pow(10.0, exponent)));
+    }
+    m_next = next;
+  }
+
+  void m_row(std::size_t const evaluation) const {
+    auto const row = std::tuple_cat(std::make_tuple(evaluation), m_keys,
+                                    std::make_tuple(m_hvo.value(), m_time));
+    if (m_sink) {
+      m_sink->push(row);
+    } else {
+      m_rows.push(row);
+    }
+    m_last = evaluation;
+  }
+
+  void m_reset() {
+    if (m_policy.step == 0) {
+      m_policy.step = 1;
+    }
+    m_hvo = hvobj<hv_type>(m_ref, m_policy.approximation);
+    m_rows.clear();
+    m_last.reset();
+    m_events.clear();
+    m_points.clear();
+    m_keys = keys_type();
+    m_start = clock::now();
+    m_offset = 0;
+    m_time = 0;
+    m_next = 0;
+    m_exponent = 0;
+  }
+
+  ovec_type m_ref;
+  anytime_policy m_policy;
+  std::shared_ptr<sink_type> m_sink;
+  clock::time_point m_start;
+  std::uint64_t m_offset = 0;
+
+  // The state below is only updated when the data is recorded (immediately or on replay)
+  mutable hvobj<hv_type> m_hvo;
+  mutable memory_sink<row_type> m_rows;
+  mutable std::optional<std::size_t> m_last;
+  mutable keys_type m_keys;
+  mutable std::uint64_t m_time = 0;
+  mutable std::size_t m_next = 0;
+  mutable std::size_t m_exponent = 0;
+
+  // Log of a deferred run: events with their evaluation/keys/elapsed time, and the inserted
+  // objective vectors (flattened, in the order they were inserted)
+  mutable std::vector<std::tuple<event, std::size_t, keys_type, std::uint64_t>> m_events;
+  mutable std::vector<hv_type> m_points;
+};
+}  // namespace priv
+}  // namespace apmnkl
+#endif  // ANYTIME_HPP
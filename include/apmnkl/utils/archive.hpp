@@ -0,0 +1,634 @@
+/**
+ * @file archive.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Implementation of an indexed archive of non-dominated solutions.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ARCHIVE_HPP
+#define ARCHIVE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "checkpoint.hpp"
+#include "solution.hpp"
+
+namespace apmnkl {
+
+namespace priv {
+
+/**
+ * @brief Archive of mutually non-dominated solutions (objectives are maximized).
+ *
+ *        The solutions are kept in a vector, in the very same order as the one
+ *        obtained by add_non_dominated on a std::vector (hence random picks give
+ *        the same results), while the dominance queries are answered through an
+ *        index on the objective vectors:
+ *          - a front sorted by the first objective in the bi-objective case
+ *            (O(log n) queries, insertions and removals);
+ *          - a ND-tree (Jaszkiewicz and Lust, 2018) for three or more objectives.
+ *        Duplicated decision vectors are detected through their hashes.
+ *
+ * @tparam S The type for the solutions (solution or one of its derived classes).
+ */
+template <typename S>
+class archive {
+  using objv_type = apmnkl::objective_vector;
+
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+  static constexpr std::size_t leaf_size = 16;
+
+  /// ND-tree node (a leaf if it has no children)
+  struct node {
+    objv_type ideal;
+    objv_type nadir;
+    std::size_t count = 0;
+    std::size_t parent = npos;
+    std::vector<std::size_t> slots;
+    std::vector<std::size_t> children;
+  };
+
+  std::size_t m_dimension = 0;
+
+  // the solutions, and the (stable) slot of each one used by the index
+  std::vector<S> m_solutions;
+  std::vector<std::size_t> m_slot;
+  std::vector<std::size_t> m_position;
+  std::vector<std::size_t> m_free_slots;
+
+  // decision vector hash -> slot
+  std::unordered_multimap<std::size_t, std::size_t> m_hashes;
+
+  // bi-objective index: first objective -> slot (the second one decreases along the front)
+  std::multimap<double, std::size_t> m_front;
+
+  // ND-tree index (the root is the first node), the nodes freed by erasures (reused by the
+  // splits) and leaf of each slot
+  std::vector<node> m_nodes;
+  std::vector<std::size_t> m_free_nodes;
+  std::vector<std::size_t> m_leaf;
+
+  // workspaces
+  std::vector<std::size_t> m_dominated;
+  std::vector<char> m_marked;
+  mutable std::vector<std::size_t> m_stack;
+
+ public:
+  using value_type = S;
+  using const_iterator = typename std::vector<S>::const_iterator;
+
+  /**
+   * @brief Construct a new (empty) archive object.
+   */
+  archive() = default;
+
+  /**
+   * @brief Getter for the number of solutions in the archive.
+   *
+   * @return std::size_t The number of solutions.
+   */
+  std::size_t size() const noexcept {
+    return m_solutions.size();
+  }
+
+  /**
+   * @brief Check if the archive is empty.
+   *
+   * @return true If the archive holds no solution.
+   */
+  bool empty() const noexcept {
+    return m_solutions.empty();
+  }
+
+  /**
+   * @brief Access the i-th solution of the archive.
+   *
+   * @param i The index of the solution.
+   * @return S const& A Read-Only reference to the solution.
+   */
+  S const &operator[](std::size_t const i) const {
+    return m_solutions[i];
+  }
+
+  /**
+   * @brief Access the last inserted solution of the archive.
+   *
+   * @return S const& A Read-Only reference to the solution.
+   */
+  S const &back() const {
+    return m_solutions.back();
+  }
+
+  /**
+   * @brief Iterators over the solutions of the archive.
+   */
+  const_iterator begin() const noexcept {
+    return m_solutions.begin();
+  }
+
+  const_iterator end() const noexcept {
+    return m_solutions.end();
+  }
+
+  /**
+   * @brief Getter for the solutions of the archive.
+   *
+   * @return std::vector<S> const& Read-Only reference to the solutions.
+   */
+  std::vector<S> const &solutions() const noexcept {
+    return m_solutions;
+  }
+
+  /**
+   * @brief Insert a solution in the archive if no solution of the archive
+   *        dominates it nor has the same decision vector, removing the solutions
+   *        it dominates (same semantics as add_non_dominated).
+   *
+   * @tparam T The type for the solution to be inserted.
+   * @param solution The solution to be inserted.
+   * @return true If the solution was inserted.
+   */
+  template <typename T>
+  bool insert(T &&solution) {
+    auto const &objv = solution.objective_vector();
+    if (m_dimension == 0) {
+      m_dimension = objv.size();
+      m_reset_tree();
+    }
+
+    if (is_dominated(objv)) {
+      return false;
+    }
+
+    std::size_t const hash = solution.decision_vector().hash();
+    auto range = m_hashes.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (m_solutions[m_position[it->second]].decision_vector() == solution.decision_vector()) {
+        return false;
+      }
+    }
+
+    m_dominated.clear();
+    m_dominated_by(objv, m_dominated);
+    m_remove(m_dominated);
+    m_push(std::forward<T>(solution), hash);
+    return true;
+  }
+
+  /**
+   * @brief Save the solutions of the archive (in order) into a checkpoint.
+   *
+   * @param writer The checkpoint writer.
+   */
+  void save(checkpoint_writer &writer) const {
+    writer.write(m_solutions);
+  }
+
+  /**
+   * @brief Load the solutions of the archive from a checkpoint, replacing its solutions. The
+   *        solutions are inserted in order into an empty archive, which gives the same order
+   *        (the index is rebuilt, but the queries do not depend on its layout).
+   *
+   * @param reader The checkpoint reader.
+   */
+  void load(checkpoint_reader &reader) {
+    std::vector<S> solutions;
+    reader.read(solutions);
+    *this = archive();
+    for (auto &solution : solutions) {
+      insert(std::move(solution));
+    }
+  }
+
+  /**
+   * @brief Remove the i-th solution of the archive, replacing it by the last one.
+   *
+   * @param i The index of the solution.
+   * @return S The removed solution.
+   */
+  S extract(std::size_t const i) {
+    m_unindex(i);
+    S solution = std::move(m_solutions[i]);
+    m_compact(i);
+    return solution;
+  }
+
+  /**
+   * @brief Check if the archive holds a solution with the same decision vector as another.
+   *
+   * @tparam T The type for the solution.
+   * @param solution The solution to be looked for.
+   * @return true If the archive holds the solution.
+   */
+  template <typename T>
+  bool contains(T const &solution) const {
+    auto range = m_hashes.equal_range(solution.decision_vector().hash());
+    for (auto it = range.first; it != range.second; ++it) {
+      if (m_solutions[m_position[it->second]].decision_vector() == solution.decision_vector()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Check if a point is dominated by a solution of the archive.
+   *
+   * @tparam P The type for the point (indexable by objective).
+   * @param point The objective values of the point.
+   * @return true If a solution of the archive dominates the point.
+   */
+  template <typename P>
+  bool is_dominated(P const &point) const {
+    if (m_solutions.empty()) {
+      return false;
+    }
+
+    if (m_dimension == 2) {
+      auto it = m_front.lower_bound(point[0]);
+      if (it == m_front.end()) {
+        return false;
+      }
+      auto const &q = m_objectives(it->second);
+      return q[1] > point[1] || (q[1] == point[1] && q[0] > point[0]);
+    }
+
+    m_stack.assign(1, 0);
+    while (!m_stack.empty()) {
+      node const &n = m_nodes[m_stack.back()];
+      m_stack.pop_back();
+
+      if (n.count == 0 || !m_weakly_dominates(n.ideal, point)) {
+        continue;
+      }
+      if (n.children.empty()) {
+        for (std::size_t slot : n.slots) {
+          if (m_dominates(m_objectives(slot), point)) {
+            return true;
+          }
+        }
+      } else if (m_dominates(n.nadir, point)) {
+        return true;
+      } else {
+        m_stack.insert(m_stack.end(), n.children.begin(), n.children.end());
+      }
+    }
+    return false;
+  }
+
+ private:
+  /// Objective vector of the solution in a slot
+  objv_type const &m_objectives(std::size_t const slot) const {
+    return m_solutions[m_position[slot]].objective_vector();
+  }
+
+  /// Check if a weakly dominates b
+  template <typename A, typename B>
+  bool m_weakly_dominates(A const &a, B const &b) const {
+    APMNKL_PROFILE_COUNT(comparisons, 1);
+    for (std::size_t k = 0; k < m_dimension; ++k) {
+      if (a[k] < b[k]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Check if a dominates b
+  template <typename A, typename B>
+  bool m_dominates(A const &a, B const &b) const {
+    APMNKL_PROFILE_COUNT(comparisons, 1);
+    bool better = false;
+    for (std::size_t k = 0; k < m_dimension; ++k) {
+      if (a[k] < b[k]) {
+        return false;
+      }
+      better = better || a[k] > b[k];
+    }
+    return better;
+  }
+
+  /// Squared distance between a point and the middle of a node
+  double m_distance(objv_type const &point, node const &n) const {
+    double d = 0.0;
+    for (std::size_t k = 0; k < m_dimension; ++k) {
+      double const delta = point[k] - 0.5 * (n.ideal[k] + n.nadir[k]);
+      d += delta * delta;
+    }
+    return d;
+  }
+
+  /// Squared distance between two points
+  double m_distance(objv_type const &a, objv_type const &b) const {
+    double d = 0.0;
+    for (std::size_t k = 0; k < m_dimension; ++k) {
+      d += (a[k] - b[k]) * (a[k] - b[k]);
+    }
+    return d;
+  }
+
+  /// Collect the slots of the solutions dominated by a point
+  template <typename P>
+  void m_dominated_by(P const &point, std::vector<std::size_t> &slots) const {
+    if (m_solutions.empty()) {
+      return;
+    }
+
+    if (m_dimension == 2) {
+      for (auto it = m_front.upper_bound(point[0]); it != m_front.begin();) {
+        --it;
+        auto const &q = m_objectives(it->second);
+        if (q[1] > point[1]) {
+          break;
+        }
+        if (m_dominates(point, q)) {
+          slots.push_back(it->second);
+        }
+      }
+      return;
+    }
+
+    m_stack.assign(1, 0);
+    while (!m_stack.empty()) {
+      node const &n = m_nodes[m_stack.back()];
+      m_stack.pop_back();
+
+      if (n.count == 0 || !m_weakly_dominates(point, n.nadir)) {
+        continue;
+      }
+      if (n.children.empty()) {
+        for (std::size_t slot : n.slots) {
+          if (m_dominates(point, m_objectives(slot))) {
+            slots.push_back(slot);
+          }
+        }
+      } else {
+        m_stack.insert(m_stack.end(), n.children.begin(), n.children.end());
+      }
+    }
+  }
+
+  /// Add a solution at the end of the archive
+  template <typename T>
+  void m_push(T &&solution, std::size_t const hash) {
+    std::size_t slot;
+    if (m_free_slots.empty()) {
+      slot = m_position.size();
+      m_position.push_back(npos);
+      m_leaf.push_back(npos);
+      m_marked.push_back(0);
+    } else {
+      slot = m_free_slots.back();
+      m_free_slots.pop_back();
+    }
+
+    m_position[slot] = m_solutions.size();
+    m_slot.push_back(slot);
+    m_solutions.push_back(std::forward<T>(solution));
+    m_hashes.emplace(hash, slot);
+
+    if (m_dimension == 2) {
+      m_front.emplace(m_objectives(slot)[0], slot);
+    } else {
+      m_tree_insert(slot);
+    }
+  }
+
+  /**
+   * Remove a set of solutions, in the order add_non_dominated would have
+   * removed them (each one being replaced by the last solution of the archive)
+   */
+  void m_remove(std::vector<std::size_t> const &slots) {
+    std::vector<std::size_t> positions;
+    positions.reserve(slots.size());
+    for (std::size_t slot : slots) {
+      m_marked[slot] = 1;
+      positions.push_back(m_position[slot]);
+    }
+    std::sort(positions.begin(), positions.end());
+
+    for (std::size_t p : positions) {
+      if (p >= m_solutions.size()) {
+        break;
+      }
+      while (p < m_solutions.size() && m_marked[m_slot[p]]) {
+        m_unindex(p);
+        m_compact(p);
+      }
+    }
+  }
+
+  /// Remove the solution at a position from the index
+  void m_unindex(std::size_t const p) {
+    std::size_t const slot = m_slot[p];
+
+    auto range = m_hashes.equal_range(m_solutions[p].decision_vector().hash());
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == slot) {
+        m_hashes.erase(it);
+        break;
+      }
+    }
+
+    if (m_dimension == 2) {
+      auto keys = m_front.equal_range(m_objectives(slot)[0]);
+      for (auto it = keys.first; it != keys.second; ++it) {
+        if (it->second == slot) {
+          m_front.erase(it);
+          break;
+        }
+      }
+    } else {
+      m_tree_erase(slot);
+    }
+  }
+
+  /// Remove the (unindexed) solution at a position, replacing it by the last one
+  void m_compact(std::size_t const p) {
+    std::size_t const slot = m_slot[p];
+    std::size_t const last = m_solutions.size() - 1;
+    if (p != last) {
+      m_solutions[p] = std::move(m_solutions[last]);
+      m_slot[p] = m_slot[last];
+      m_position[m_slot[p]] = p;
+    }
+    m_solutions.pop_back();
+    m_slot.pop_back();
+
+    m_position[slot] = npos;
+    m_marked[slot] = 0;
+    m_free_slots.push_back(slot);
+  }
+
+  /// Reset the ND-tree to an empty root leaf
+  void m_reset_tree() {
+    m_nodes.assign(1, node());
+    m_free_nodes.clear();
+  }
+
+  /// Get a new (empty) node, reusing a node freed by an erasure if any
+  std::size_t m_new_node(std::size_t const parent) {
+    std::size_t index = m_nodes.size();
+    if (m_free_nodes.empty()) {
+      m_nodes.emplace_back();
+    } else {
+      index = m_free_nodes.back();
+      m_free_nodes.pop_back();
+    }
+    node &n = m_nodes[index];
+    n.count = 0;
+    n.parent = parent;
+    n.slots.clear();
+    n.children.clear();
+    return index;
+  }
+
+  /// Insert a slot in the ND-tree, in the leaf with the closest middle point
+  void m_tree_insert(std::size_t const slot) {
+    auto const &point = m_objectives(slot);
+    std::size_t current = 0;
+
+    for (;;) {
+      node &n = m_nodes[current];
+      if (n.count == 0) {
+        n.ideal = point;
+        n.nadir = point;
+      } else {
+        for (std::size_t k = 0; k < m_dimension; ++k) {
+          n.ideal[k] = std::max(n.ideal[k], point[k]);
+          n.nadir[k] = std::min(n.nadir[k], point[k]);
+        }
+      }
+      ++n.count;
+
+      if (n.children.empty()) {
+        n.slots.push_back(slot);
+        m_leaf[slot] = current;
+        if (n.slots.size() > leaf_size) {
+          m_tree_split(current);
+        }
+        return;
+      }
+
+      std::size_t closest = n.children.front();
+      double best = m_distance(point, m_nodes[closest]);
+      for (std::size_t child : n.children) {
+        double const d = m_distance(point, m_nodes[child]);
+        if (d < best) {
+          best = d;
+          closest = child;
+        }
+      }
+      current = closest;
+    }
+  }
+
+  /// Split a full leaf into (at most) M + 1 leaves built around distant seed points
+  void m_tree_split(std::size_t const leaf) {
+    std::vector<std::size_t> slots = std::move(m_nodes[leaf].slots);
+    m_nodes[leaf].slots.clear();
+
+    std::vector<std::size_t> seeds;
+    std::vector<double> closest(slots.size(), std::numeric_limits<double>::max());
+
+    std::size_t first = 0;
+    double largest = -1.0;
+    for (std::size_t a = 0; a < slots.size(); ++a) {
+      double sum = 0.0;
+      for (std::size_t b = 0; b < slots.size(); ++b) {
+        sum += m_distance(m_objectives(slots[a]), m_objectives(slots[b]));
+      }
+      if (sum > largest) {
+        largest = sum;
+        first = a;
+      }
+    }
+    seeds.push_back(first);
+
+    while (seeds.size() < std::min(m_dimension + 1, slots.size())) {
+      std::size_t next = 0;
+      largest = -1.0;
+      for (std::size_t a = 0; a < slots.size(); ++a) {
+        closest[a] = std::min(
+            closest[a], m_distance(m_objectives(slots[a]), m_objectives(slots[seeds.back()])));
+        if (closest[a] > largest) {
+          largest = closest[a];
+          next = a;
+        }
+      }
+      seeds.push_back(next);
+    }
+
+    std::vector<std::size_t> children;
+    for (std::size_t seed : seeds) {
+      std::size_t const index = m_new_node(leaf);
+      node &child = m_nodes[index];
+      child.ideal = m_objectives(slots[seed]);
+      child.nadir = child.ideal;
+      children.push_back(index);
+    }
+
+    for (std::size_t slot : slots) {
+      auto const &point = m_objectives(slot);
+      std::size_t target = children.front();
+      double best = std::numeric_limits<double>::max();
+      for (std::size_t s = 0; s < seeds.size(); ++s) {
+        double const d = m_distance(point, m_objectives(slots[seeds[s]]));
+        if (d < best) {
+          best = d;
+          target = children[s];
+        }
+      }
+
+      node &child = m_nodes[target];
+      for (std::size_t k = 0; k < m_dimension; ++k) {
+        child.ideal[k] = std::max(child.ideal[k], point[k]);
+        child.nadir[k] = std::min(child.nadir[k], point[k]);
+      }
+      ++child.count;
+      child.slots.push_back(slot);
+      m_leaf[slot] = target;
+    }
+
+    m_nodes[leaf].children = std::move(children);
+  }
+
+  /// Remove a slot from the ND-tree (the bounds of its ancestors are kept as approximations),
+  /// freeing the nodes it empties (an empty node has no children left)
+  void m_tree_erase(std::size_t const slot) {
+    std::size_t current = m_leaf[slot];
+    auto &slots = m_nodes[current].slots;
+    slots.erase(std::find(slots.begin(), slots.end(), slot));
+    m_leaf[slot] = npos;
+
+    while (current != npos) {
+      node &n = m_nodes[current];
+      std::size_t const parent = n.parent;
+      if (--n.count == 0 && parent != npos) {
+        auto &siblings = m_nodes[parent].children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), current));
+        m_free_nodes.push_back(current);
+      }
+      current = parent;
+    }
+
+    if (m_nodes.front().count == 0) {
+      m_reset_tree();
+    }
+  }
+};
+
+}  // namespace priv
+}  // namespace apmnkl
+#endif  // ARCHIVE_HPP
@@ -0,0 +1,282 @@
+/**
+ * @file bitset.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Implementation of a packed bitset used to store decision vectors.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef BITSET_HPP
+#define BITSET_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace apmnkl {
+
+namespace priv {
+
+/// Packed bitset with inline storage for small sizes (no heap allocation up to 256 bits)
+class packed_bitset {
+ public:
+  using word_type = std::uint64_t;
+
+  static constexpr std::size_t word_bits = 64;
+  static constexpr std::size_t inline_words = 4;
+
+ private:
+  std::size_t m_size;
+  std::array<word_type, inline_words> m_inline;
+  std::vector<word_type> m_heap;
+
+ public:
+  /**
+   * @brief Construct a new (empty) packed_bitset object.
+   */
+  packed_bitset() noexcept
+      : m_size(0)
+      , m_inline() {}
+
+  /**
+   * @brief Construct a new packed_bitset object.
+   *
+   * @param size The number of bits of the bitset.
+   * @param value The initial value of every bit.
+   */
+  explicit packed_bitset(std::size_t const size, bool const value = false)
+      : m_size(size)
+      , m_inline()
+      , m_heap(words_for(size) > inline_words ? words_for(size) : 0) {
+    if (value) {
+      std::fill(data(), data() + word_count(), ~word_type(0));
+      m_clear_padding();
+    }
+  }
+
+  /**
+   * @brief Number of words needed to store a given number of bits.
+   *
+   * @param size The number of bits.
+   * @return constexpr std::size_t The number of words.
+   */
+  static constexpr std::size_t words_for(std::size_t const size) noexcept {
+    return (size + word_bits - 1) / word_bits;
+  }
+
+  /**
+   * @brief Getter for the number of bits in the bitset.
+   *
+   * @return std::size_t The number of bits.
+   */
+  std::size_t size() const noexcept {
+    return m_size;
+  }
+
+  /**
+   * @brief Getter for the number of words used by the bitset.
+   *
+   * @return std::size_t The number of words.
+   */
+  std::size_t word_count() const noexcept {
+    return words_for(m_size);
+  }
+
+  /**
+   * @brief Getter for the bitset words. Bits past size() are always zero.
+   *
+   * @return word_type const* A pointer to the first word.
+   */
+  word_type const *data() const noexcept {
+    return m_heap.empty() ? m_inline.data() : m_heap.data();
+  }
+
+  /**
+   * @brief Getter for the bitset words. Bits past size() must be kept zero.
+   *
+   * @return word_type* A pointer to the first word.
+   */
+  word_type *data() noexcept {
+    return m_heap.empty() ? m_inline.data() : m_heap.data();
+  }
+
+  /**
+   * @brief Access the i-th bit of the bitset.
+   *
+   * @param i The index of the bit.
+   * @return bool The value of the bit.
+   */
+  bool operator[](std::size_t const i) const noexcept {
+    return test(i);
+  }
+
+  /**
+   * @brief Access the i-th bit of the bitset.
+   *
+   * @param i The index of the bit.
+   * @return bool The value of the bit.
+   */
+  bool test(std::size_t const i) const noexcept {
+    assert(i < m_size);
+    return (data()[i / word_bits] >> (i % word_bits)) & 1;
+  }
+
+  /**
+   * @brief Set the value of the i-th bit of the bitset.
+   *
+   * @param i The index of the bit.
+   * @param value The new value of the bit.
+   */
+  void set(std::size_t const i, bool const value = true) noexcept {
+    assert(i < m_size);
+    word_type const bit = word_type(1) << (i % word_bits);
+    if (value) {
+      data()[i / word_bits] |= bit;
+    } else {
+      data()[i / word_bits] &= ~bit;
+    }
+  }
+
+  /**
+   * @brief Flip the i-th bit of the bitset.
+   *
+   * @param i The index of the bit.
+   */
+  void flip(std::size_t const i) noexcept {
+    assert(i < m_size);
+    data()[i / word_bits] ^= word_type(1) << (i % word_bits);
+  }
+
+  /**
+   * @brief Flip every bit set in a mask (word-level XOR).
+   *
+   * @param mask The flip mask (of the same size as this bitset).
+   */
+  void flip(packed_bitset const &mask) noexcept {
+    assert(mask.m_size == m_size);
+    word_type *w = data();
+    word_type const *m = mask.data();
+    for (std::size_t k = 0; k < word_count(); ++k) {
+      w[k] ^= m[k];
+    }
+  }
+
+  /**
+   * @brief Exchange with another bitset the bits set in a mask
+   *        (word-level uniform crossover).
+   *
+   * @param other The bitset to exchange bits with.
+   * @param mask The crossover mask (of the same size as both bitsets).
+   */
+  void swap_masked(packed_bitset &other, packed_bitset const &mask) noexcept {
+    assert(other.m_size == m_size && mask.m_size == m_size);
+    word_type *a = data();
+    word_type *b = other.data();
+    word_type const *m = mask.data();
+    for (std::size_t k = 0; k < word_count(); ++k) {
+      word_type const d = (a[k] ^ b[k]) & m[k];
+      a[k] ^= d;
+      b[k] ^= d;
+    }
+  }
+
+  /**
+   * @brief Exchange with another bitset the bits in the range [first, last)
+   *        (word-level n-point crossover segment).
+   *
+   * @param other The bitset to exchange bits with.
+   * @param first The index of the first bit of the range.
+   * @param last The index past the last bit of the range.
+   */
+  void swap_range(packed_bitset &other, std::size_t const first, std::size_t const last) noexcept {
+    assert(other.m_size == m_size && first <= last && last <= m_size);
+    if (first == last) {
+      return;
+    }
+    word_type *a = data();
+    word_type *b = other.data();
+    std::size_t const fw = first / word_bits;
+    std::size_t const lw = (last - 1) / word_bits;
+    for (std::size_t k = fw; k <= lw; ++k) {
+      word_type m = ~word_type(0);
+      if (k == fw) {
+        m &= ~word_type(0) << (first % word_bits);
+      }
+      if (k == lw && last % word_bits != 0) {
+        m &= ~(~word_type(0) << (last % word_bits));
+      }
+      word_type const d = (a[k] ^ b[k]) & m;
+      a[k] ^= d;
+      b[k] ^= d;
+    }
+  }
+
+  /**
+   * @brief Hash value of the bitset.
+   *
+   * @return std::size_t The hash value.
+   */
+  std::size_t hash() const noexcept {
+    std::uint64_t h = 0x9e3779b97f4a7c15ull ^ m_size;
+    word_type const *w = data();
+    for (std::size_t k = 0; k < word_count(); ++k) {
+      h ^= w[k] + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+      h *= 0xbf58476d1ce4e5b9ull;
+      h ^= h >> 31;
+    }
+    return static_cast<std::size_t>(h);
+  }
+
+  /**
+   * @brief Equality operator (word-wise comparison).
+   *
+   * @param lhs The first bitset.
+   * @param rhs The second bitset.
+   * @return true If both bitsets have the same size and bits.
+   */
+  friend bool operator==(packed_bitset const &lhs, packed_bitset const &rhs) noexcept {
+    return lhs.m_size == rhs.m_size &&
+           std::equal(lhs.data(), lhs.data() + lhs.word_count(), rhs.data());
+  }
+
+  /**
+   * @brief Inequality operator (word-wise comparison).
+   *
+   * @param lhs The first bitset.
+   * @param rhs The second bitset.
+   * @return true If the bitsets differ in size or in any bit.
+   */
+  friend bool operator!=(packed_bitset const &lhs, packed_bitset const &rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+ private:
+  /// Clear the bits of the last word that are past size()
+  void m_clear_padding() noexcept {
+    if (m_size % word_bits != 0) {
+      data()[word_count() - 1] &= ~(~word_type(0) << (m_size % word_bits));
+    }
+  }
+};
+
+}  // namespace priv
+}  // namespace apmnkl
+
+namespace std {
+/// std::hash specialization for packed bitsets (e.g. to be used by std::unordered_set)
+template <>
+struct hash<apmnkl::priv::packed_bitset> {
+  std::size_t operator()(apmnkl::priv::packed_bitset const &b) const noexcept {
+    return b.hash();
+  }
+};
+}  // namespace std
+
+#endif  // BITSET_HPP
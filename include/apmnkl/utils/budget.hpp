@@ -0,0 +1,125 @@
+/**
+ * @file budget.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Stopping criteria of the runs other than the maximum number of evaluations: a
+ *        wall-clock time budget and a (signal-safe) stop request.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef BUDGET_HPP
+#define BUDGET_HPP
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace apmnkl {
+
+namespace priv {
+
+// raised to stop every run of the process, it must be lock-free to be set by a signal handler
+inline std::atomic<bool> stop_flag(false);
+static_assert(std::atomic<bool>::is_always_lock_free, "the stop flag must be lock-free");
+
+/// Signal handler requesting every run to stop
+extern "C" inline void stop_handler(int) {
+  stop_flag.store(true, std::memory_order_relaxed);
+}
+}  // namespace priv
+
+/// Request every run of the process to stop (async-signal-safe)
+inline void request_stop() noexcept {
+  priv::stop_flag.store(true, std::memory_order_relaxed);
+}
+
+/// Check if the runs of the process were requested to stop
+[[nodiscard]] inline bool stop_requested() noexcept {
+  return priv::stop_flag.load(std::memory_order_relaxed);
+}
+
+/// Withdraw a stop request (e.g. before starting new runs)
+inline void clear_stop_request() noexcept {
+  priv::stop_flag.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Request every run of the process to stop when one of the given signals arrives.
+ *        The runs then return cleanly (as if their budget was exhausted), so their anytime
+ *        data is flushed and their archive is kept.
+ *
+ * @param signals The signals stopping the runs.
+ */
+inline void stop_on_signals(std::initializer_list<int> const signals = {SIGTERM, SIGUSR1}) {
+  for (auto const signal : signals) {
+    std::signal(signal, priv::stop_handler);
+  }
+}
+
+namespace priv {
+
+/**
+ * @brief Wall-clock time budget of a run. The clock (and the stop request) is only checked
+ *        once every `interval` evaluations, so checking the budget in the inner loop of the
+ *        algorithms costs a comparison most of the time.
+ */
+class time_budget {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Set the budget (before running the algorithm).
+   *
+   * @param limit The wall-clock time limit of the run (zero for no limit).
+   * @param interval The number of evaluations between two checks of the clock.
+   */
+  void set(std::chrono::nanoseconds const limit, std::size_t const interval) {
+    m_limit = limit;
+    m_interval = interval != 0 ? interval : 1;
+  }
+
+  /// Start the budget of a run
+  void start() {
+    m_deadline = clock::now() + m_limit;
+    m_next = 0;
+    m_expired = false;
+  }
+
+  /**
+   * @brief Check if the run must stop, reading the clock if `interval` evaluations were
+   *        performed since the last check. Once expired, the budget of the run stays expired.
+   *
+   * @param evaluation The evaluations performed so far.
+   * @return true If the run must stop (time limit reached or stop requested).
+   */
+  [[nodiscard]] bool expired(std::size_t const evaluation) {
+    if (m_expired || evaluation < m_next) {
+      return m_expired;
+    }
+    m_next = evaluation + m_interval;
+    m_expired = stop_requested() || (m_limit.count() != 0 && clock::now() >= m_deadline);
+    return m_expired;
+  }
+
+  /// Check if the budget of the run expired (on its last check)
+  [[nodiscard]] bool expired() const noexcept {
+    return m_expired;
+  }
+
+ private:
+  std::chrono::nanoseconds m_limit{0};
+  std::size_t m_interval = 1000;
+  clock::time_point m_deadline;
+  std::size_t m_next = 0;
+  bool m_expired = false;
+};
+}  // namespace priv
+}  // namespace apmnkl
+#endif  // BUDGET_HPP
@@ -0,0 +1,240 @@
+/**
+ * @file cache.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Bounded cache of the evaluations of the search heuristics: a fixed-size open-addressing
+ *        hash table from decision vectors to objective vectors, lock-free so the threads of the
+ *        parallel modes share it.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CACHE_HPP
+#define CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "bitset.hpp"
+#include "checkpoint.hpp"
+
+namespace apmnkl {
+
+/// Cache of the evaluations of a run (disabled unless slots are given)
+struct evaluation_cache_policy {
+  /// Number of slots of the hash table, i.e. the evaluations kept at most (0 for no cache)
+  std::size_t slots = 0;
+
+  /// Count the hits as evaluations (of the maximum number of evaluations of the run), so a run
+  /// performs the very same search with or without the cache. Otherwise only the evaluations
+  /// actually performed are counted.
+  bool count_hits = true;
+};
+
+namespace priv {
+
+/**
+ * @brief Bounded cache of evaluations: a fixed-size open-addressing hash table from decision
+ *        vectors to objective vectors. A decision vector is looked up in a window of slots
+ *        from its home slot (linear probing), and inserted into the first free slot of the
+ *        window, or in place of its home slot once the window is full (the table never grows).
+ *        Every slot is guarded by a sequence lock, so concurrent lookups and insertions need
+ *        no lock: a lookup misses if the slot is being written (its version is odd) or was
+ *        written meanwhile (its version changed), and an insertion is dropped if another
+ *        thread is writing the slot. The slots are stored as atomic words (relaxed accesses,
+ *        plain loads and stores on common hardware), so the concurrent accesses are race-free.
+ */
+class evaluation_cache {
+ public:
+  using word_type = packed_bitset::word_type;
+
+  /// Number of slots probed from the home slot of a decision vector
+  static constexpr std::size_t window = 8;
+
+  evaluation_cache() = default;
+
+  /**
+   * @brief Construct a new (empty) evaluation_cache object.
+   *
+   * @param slots The number of slots (rounded up to a power of two, of at least one window).
+   * @param n The number of bits of the decision vectors.
+   * @param m The number of objectives.
+   */
+  evaluation_cache(std::size_t const slots, std::size_t const n, std::size_t const m)
+      : m_n(n)
+      , m_m(m)
+      , m_words(packed_bitset::words_for(n))
+      , m_stride(2 + m_words + m) {
+    m_slots = window;
+    while (m_slots < slots) {
+      m_slots *= 2;
+    }
+    m_table = std::make_unique<std::atomic<std::uint64_t>[]>(m_slots * m_stride);
+    for (std::size_t k = 0; k < m_slots * m_stride; ++k) {
+      m_table[k].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /// Check if the cache is enabled (i.e. has slots)
+  [[nodiscard]] bool enabled() const noexcept {
+    return m_slots != 0;
+  }
+
+  /// Get the number of slots
+  [[nodiscard]] std::size_t slots() const noexcept {
+    return m_slots;
+  }
+
+  /**
+   * @brief Look up the objective vector of a decision vector.
+   *
+   * @param decision The decision vector.
+   * @param objective The objective vector (resized and set on a hit, left as is otherwise).
+   * @return true If the cache holds the decision vector.
+   */
+  bool find(packed_bitset const &decision, std::vector<double> &objective) const {
+    auto const hash = static_cast<std::uint64_t>(decision.hash());
+    for (std::size_t p = 0; p < window; ++p) {
+      auto const *slot = m_slot(hash, p);
+      auto const version = slot[0].load(std::memory_order_acquire);
+      if (version == 0) {
+        return false;
+      }
+      if (version % 2 != 0 || slot[1].load(std::memory_order_relaxed) != hash ||
+          !m_matches(slot, decision)) {
+        continue;
+      }
+      objective.resize(m_m);
+      for (std::size_t i = 0; i < m_m; ++i) {
+        auto const bits = slot[2 + m_words + i].load(std::memory_order_relaxed);
+        std::memcpy(&objective[i], &bits, sizeof(bits));
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot[0].load(std::memory_order_relaxed) == version) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Insert the evaluation of a decision vector (nothing is done if the cache already
+   *        holds it, or if another thread is writing its slot).
+   *
+   * @tparam V The type for the objective vector (indexable by objective).
+   * @param decision The decision vector.
+   * @param objective The objective vector.
+   */
+  template <typename V>
+  void insert(packed_bitset const &decision, V const &objective) {
+    auto const hash = static_cast<std::uint64_t>(decision.hash());
+    auto *victim = m_slot(hash, 0);
+    for (std::size_t p = 0; p < window; ++p) {
+      auto *slot = m_slot(hash, p);
+      auto const version = slot[0].load(std::memory_order_relaxed);
+      if (version == 0) {
+        victim = slot;
+        break;
+      }
+      if (version % 2 == 0 && slot[1].load(std::memory_order_relaxed) == hash &&
+          m_matches(slot, decision)) {
+        return;
+      }
+    }
+
+    auto version = victim[0].load(std::memory_order_relaxed);
+    if (version % 2 != 0 ||
+        !victim[0].compare_exchange_strong(version, version + 1, std::memory_order_relaxed)) {
+      return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    victim[1].store(hash, std::memory_order_relaxed);
+    for (std::size_t k = 0; k < m_words; ++k) {
+      victim[2 + k].store(decision.data()[k], std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < m_m; ++i) {
+      double const value = objective[i];
+      std::uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      victim[2 + m_words + i].store(bits, std::memory_order_relaxed);
+    }
+    victim[0].store(version + 2, std::memory_order_release);
+  }
+
+  /**
+   * @brief Save the cache (its dimensions and slots) into a checkpoint (while no other thread
+   *        accesses it).
+   *
+   * @param writer The checkpoint writer.
+   */
+  void save(checkpoint_writer &writer) const {
+    writer.write(std::make_tuple(m_slots, m_n, m_m));
+    std::vector<std::uint64_t> table(m_slots * m_stride);
+    for (std::size_t k = 0; k < table.size(); ++k) {
+      table[k] = m_table[k].load(std::memory_order_relaxed);
+    }
+    writer.write(table);
+  }
+
+  /**
+   * @brief Load the cache from a checkpoint.
+   *
+   * @param reader The checkpoint reader.
+   */
+  void load(checkpoint_reader &reader) {
+    std::size_t slots = 0;
+    std::size_t n = 0;
+    std::size_t m = 0;
+    auto dimensions = std::tie(slots, n, m);
+    reader.read(dimensions);
+    std::vector<std::uint64_t> table;
+    reader.read(table);
+    // checked before the table is allocated (the table read is bounded by the checkpoint)
+    auto const stride = slots != 0 ? 2 + packed_bitset::words_for(n) + m : 1;
+    if (table.size() % stride != 0 || table.size() / stride != slots ||
+        (slots != 0 && (slots < window || (slots & (slots - 1)) != 0))) {
+      throw std::runtime_error("invalid checkpoint: the evaluation cache is corrupted");
+    }
+    *this = slots != 0 ? evaluation_cache(slots, n, m) : evaluation_cache();
+    for (std::size_t k = 0; k < table.size(); ++k) {
+      m_table[k].store(table[k], std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  /// Get the p-th slot of the window of a hash value ([version][hash][decision][objective])
+  [[nodiscard]] std::atomic<std::uint64_t> *m_slot(std::uint64_t const hash,
+                                                   std::size_t const p) const {
+    return m_table.get() + ((hash + p) & (m_slots - 1)) * m_stride;
+  }
+
+  /// Check if a slot holds a decision vector
+  [[nodiscard]] bool m_matches(std::atomic<std::uint64_t> const *slot,
+                               packed_bitset const &decision) const {
+    for (std::size_t k = 0; k < m_words; ++k) {
+      if (slot[2 + k].load(std::memory_order_relaxed) != decision.data()[k]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::size_t m_n = 0;
+  std::size_t m_m = 0;
+  std::size_t m_words = 0;
+  std::size_t m_stride = 0;
+  std::size_t m_slots = 0;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> m_table;
+};
+}  // namespace priv
+}  // namespace apmnkl
+#endif  // CACHE_HPP
@@ -0,0 +1,303 @@
+/**
+ * @file checkpoint.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Binary checkpoints holding the state of a run of the search heuristics (to resume it).
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rMNKEval.hpp"
+
+namespace apmnkl {
+
+namespace priv {
+
+/**
+ * @brief Writer of the state of a run into a checkpoint. The values are written in binary
+ *        (native byte order), the sizes of the containers as uint64 and the classes through
+ *        their save member, e.g. `void save(checkpoint_writer &writer) const`.
+ */
+class checkpoint_writer {
+ public:
+  explicit checkpoint_writer(std::ostream &os)
+      : m_os(os) {}
+
+  /// Write an arithmetic (or enumeration) value
+  template <typename V, std::enable_if_t<std::is_arithmetic_v<V> || std::is_enum_v<V>, int> = 0>
+  void write(V const value) {
+    m_os.write(reinterpret_cast<char const *>(&value), sizeof(value));
+  }
+
+  /// Write an object through its save member
+  template <typename V>
+  auto write(V const &value) -> decltype(value.save(*this), void()) {
+    value.save(*this);
+  }
+
+  /// Write a string
+  void write(std::string const &value) {
+    write_size(value.size());
+    m_os.write(value.data(), static_cast<std::streamsize>(value.size()));
+  }
+
+  /// Write a vector (its size followed by its elements)
+  template <typename V, typename A>
+  void write(std::vector<V, A> const &values) {
+    write_size(values.size());
+    if constexpr (std::is_arithmetic_v<V>) {
+      write_block(values.data(), values.size());
+    } else {
+      for (auto const &value : values) {
+        write(value);
+      }
+    }
+  }
+
+  /// Write a tuple (its elements in order)
+  template <typename... Ts>
+  void write(std::tuple<Ts...> const &values) {
+    std::apply([this](auto const &...value) { (write(value), ...); }, values);
+  }
+
+  /// Write an optional value (a flag followed by the value, if any)
+  template <typename V>
+  void write(std::optional<V> const &value) {
+    write(value.has_value());
+    if (value) {
+      write(*value);
+    }
+  }
+
+  /// Write a size (as uint64)
+  void write_size(std::size_t const size) {
+    write(static_cast<std::uint64_t>(size));
+  }
+
+  /// Write a block of arithmetic values (without its size)
+  template <typename V>
+  void write_block(V const *values, std::size_t const count) {
+    static_assert(std::is_arithmetic_v<V>, "only arithmetic blocks can be written");
+    m_os.write(reinterpret_cast<char const *>(values),
+               static_cast<std::streamsize>(count * sizeof(V)));
+  }
+
+  /// Write the state of a pseudo random number engine (or distribution), as its textual
+  /// representation (the portable way the standard gives to save it)
+  template <typename E>
+  void write_state(E const &engine) {
+    std::ostringstream ss;
+    ss << engine;
+    write(ss.str());
+  }
+
+ private:
+  std::ostream &m_os;
+};
+
+/**
+ * @brief Reader of the state of a run from a checkpoint (written by a checkpoint_writer).
+ *        A truncated checkpoint raises a std::runtime_error, and so does a container larger
+ *        than what is left of the checkpoint (if the stream is seekable), before its elements
+ *        are allocated.
+ */
+class checkpoint_reader {
+ public:
+  explicit checkpoint_reader(std::istream &is)
+      : m_is(is)
+      , m_left(m_remaining(is)) {}
+
+  /// Read an arithmetic (or enumeration) value
+  template <typename V, std::enable_if_t<std::is_arithmetic_v<V> || std::is_enum_v<V>, int> = 0>
+  void read(V &value) {
+    m_read(reinterpret_cast<char *>(&value), sizeof(value));
+  }
+
+  /// Read an object through its load member
+  template <typename V>
+  auto read(V &value) -> decltype(value.load(*this), void()) {
+    value.load(*this);
+  }
+
+  /// Read a string
+  void read(std::string &value) {
+    value.resize(read_length());
+    m_read(value.data(), value.size());
+  }
+
+  /// Read a vector (its size followed by its elements)
+  template <typename V, typename A>
+  void read(std::vector<V, A> &values) {
+    values.resize(read_length(std::is_arithmetic_v<V> ? sizeof(V) : 1));
+    if constexpr (std::is_arithmetic_v<V>) {
+      read_block(values.data(), values.size());
+    } else {
+      for (auto &value : values) {
+        read(value);
+      }
+    }
+  }
+
+  /// Read a tuple (its elements in order)
+  template <typename... Ts>
+  void read(std::tuple<Ts...> &values) {
+    std::apply([this](auto &...value) { (read(value), ...); }, values);
+  }
+
+  /// Read an optional value
+  template <typename V>
+  void read(std::optional<V> &value) {
+    bool has_value = false;
+    read(has_value);
+    value.reset();
+    if (has_value) {
+      read(value.emplace());
+    }
+  }
+
+  /// Read a size (written as uint64)
+  [[nodiscard]] std::size_t read_size() {
+    std::uint64_t size = 0;
+    read(size);
+    return static_cast<std::size_t>(size);
+  }
+
+  /**
+   * @brief Read the number of elements of a container (written as a size), checking that
+   *        they fit in what is left of the checkpoint.
+   *
+   * @param bytes The least number of bytes taken by an element in the checkpoint.
+   * @return std::size_t The number of elements.
+   * @throws std::runtime_error If the elements do not fit in what is left of the checkpoint.
+   */
+  [[nodiscard]] std::size_t read_length(std::size_t const bytes = 1) {
+    std::uint64_t length = 0;
+    read(length);
+    if (length > m_left / bytes) {
+      throw std::runtime_error("corrupted checkpoint (container beyond the end of the file)");
+    }
+    return static_cast<std::size_t>(length);
+  }
+
+  /// Read a block of arithmetic values (of a known size)
+  template <typename V>
+  void read_block(V *values, std::size_t const count) {
+    static_assert(std::is_arithmetic_v<V>, "only arithmetic blocks can be read");
+    m_read(reinterpret_cast<char *>(values), count * sizeof(V));
+  }
+
+  /// Read the state of a pseudo random number engine (or distribution)
+  template <typename E>
+  void read_state(E &engine) {
+    std::string state;
+    read(state);
+    std::istringstream ss(state);
+    ss >> engine;
+    if (!ss) {
+      throw std::runtime_error("corrupted checkpoint (invalid generator state)");
+    }
+  }
+
+ private:
+  /// Get the number of bytes left in a stream (unbounded if it is not seekable)
+  static std::size_t m_remaining(std::istream &is) {
+    auto const position = is.tellg();
+    if (position < 0 || !is.seekg(0, std::ios::end)) {
+      is.clear();
+      return std::numeric_limits<std::size_t>::max();
+    }
+    auto const end = is.tellg();
+    is.seekg(position);
+    return end < position ? 0 : static_cast<std::size_t>(end - position);
+  }
+
+  /// Read a number of bytes, checking the stream state
+  void m_read(char *data, std::size_t const bytes) {
+    if (bytes > m_left) {
+      throw std::runtime_error("truncated checkpoint");
+    }
+    m_is.read(data, static_cast<std::streamsize>(bytes));
+    if (!m_is) {
+      throw std::runtime_error("truncated checkpoint");
+    }
+    m_left -= bytes;
+  }
+
+  std::istream &m_is;
+  // the bytes left in the checkpoint
+  std::size_t m_left;
+};
+
+/// Magic and version of the checkpoints
+inline constexpr char checkpoint_magic[8] = {'A', 'P', 'M', 'N', 'K', 'L', 'C', 'K'};
+inline constexpr std::uint32_t checkpoint_version = 5;
+
+/**
+ * @brief Write the header of a checkpoint: the magic "APMNKLCK", the version of the format,
+ *        the name of the algorithm and the parameters (M, N, K) of the instance.
+ *
+ * @param writer The checkpoint writer.
+ * @param algorithm The name of the algorithm.
+ * @param eval The evaluator of the instance.
+ */
+inline void write_checkpoint_header(checkpoint_writer &writer, std::string const &algorithm,
+                                    RMNKEval const &eval) {
+  writer.write_block(checkpoint_magic, sizeof(checkpoint_magic));
+  writer.write(checkpoint_version);
+  writer.write(algorithm);
+  writer.write(std::make_tuple(eval.getM(), eval.getN(), eval.getK()));
+}
+
+/**
+ * @brief Read (and check) the header of a checkpoint.
+ *
+ * @param reader The checkpoint reader.
+ * @param algorithm The name of the algorithm resuming the run.
+ * @param eval The evaluator of the instance of the run.
+ * @throws std::runtime_error If the checkpoint is not a checkpoint of a run of the algorithm
+ *         on an instance with the same parameters.
+ */
+inline void read_checkpoint_header(checkpoint_reader &reader, std::string const &algorithm,
+                                   RMNKEval const &eval) {
+  char magic[sizeof(checkpoint_magic)];
+  std::uint32_t version = 0;
+  reader.read_block(magic, sizeof(magic));
+  reader.read(version);
+  if (std::memcmp(magic, checkpoint_magic, sizeof(magic)) != 0 || version != checkpoint_version) {
+    throw std::runtime_error("not a checkpoint (or unsupported version)");
+  }
+
+  std::string name;
+  std::tuple<unsigned, unsigned, unsigned> instance;
+  reader.read(name);
+  reader.read(instance);
+  if (name != algorithm) {
+    throw std::runtime_error("the checkpoint holds a run of " + name + ", not of " + algorithm);
+  }
+  if (instance != std::make_tuple(eval.getM(), eval.getN(), eval.getK())) {
+    throw std::runtime_error("the checkpoint holds a run on a different instance");
+  }
+}
+}  // namespace priv
+}  // namespace apmnkl
+#endif  // CHECKPOINT_HPP
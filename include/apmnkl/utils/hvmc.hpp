@@ -0,0 +1,307 @@
+/**
+ * @file hvmc.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Monte Carlo estimate of the hypervolume, maintained incrementally over a fixed set of
+ *        samples of the box between the reference point and the upper bound of the objectives.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef HVMC_HPP
+#define HVMC_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "profile.hpp"
+
+namespace apmnkl {
+
+/// Approximation of the hypervolume by Monte Carlo sampling (the exact hypervolume is
+/// computed unless samples are given)
+struct hv_approximation {
+  /// Number of samples drawn in the box between the reference point and the upper bound
+  /// (0 for the exact hypervolume)
+  std::size_t samples = 0;
+
+  /// Upper bound of every objective, i.e. the opposite corner of the box of the samples (the
+  /// objective values of the rho-mnk landscapes are within [0, 1])
+  double upper = 1.0;
+
+  /// Seed of the samples (fixed, so every run estimates with the same samples)
+  std::uint64_t seed = 0;
+};
+
+namespace priv {
+
+/**
+ * @brief Monte Carlo estimate of the hypervolume of a set of (maximized) objective vectors:
+ *        the volume of the box times the fraction of its samples dominated by the set. The
+ *        samples are drawn once (with a fixed seed) and marked in a bitmap once dominated,
+ *        while the undominated ones are kept packed (one array per objective) and ordered by
+ *        their largest objective, so an insertion only tests the samples left whose largest
+ *        objective does not exceed the one of the vector, and these tests run over contiguous
+ *        arrays (vectorized by the compiler). The standard error of the estimate is
+ *        V sqrt(p (1 - p) / S), for a box of volume V and a fraction p of S samples.
+ *
+ * @tparam T The type for the objective values (and the hypervolume).
+ */
+template <typename T>
+class hvmc {
+ public:
+  using hv_type = T;
+  using ovec_type = std::vector<hv_type>;
+  /// The samples are stored in single precision (well within the precision of the estimate)
+  using sample_type = float;
+
+  /**
+   * @brief Construct a new hvmc object, drawing the samples (none if the estimate is disabled,
+   *        i.e. the exact hypervolume is computed instead).
+   *
+   * @param ref The reference point (the lower corner of the box of the samples).
+   * @param approximation The number of samples, the upper bound and the seed.
+   * @throws std::invalid_argument If the upper bound is not above the reference point (and the
+   *         estimate is enabled).
+   */
+  hvmc(ovec_type const& ref, hv_approximation const& approximation)
+      : m_approximation(approximation)
+      , m_m(ref.size())
+      , m_s(approximation.samples)
+      , m_left(approximation.samples)
+      , m_volume(1) {
+    for (auto const r : ref) {
+      if (m_s != 0 && !(static_cast<hv_type>(approximation.upper) > r)) {
+        throw std::invalid_argument("the upper bound of the samples is not above the reference");
+      }
+      m_volume *= static_cast<hv_type>(approximation.upper) - r;
+    }
+
+    // uniform samples from the 24 high bits of the generator (exactly representable floats)
+    std::mt19937_64 generator(approximation.seed);
+    std::vector<sample_type> samples(m_m * m_s);
+    m_key.resize(m_s);
+    for (std::size_t j = 0; j < m_s; ++j) {
+      for (std::size_t i = 0; i < m_m; ++i) {
+        auto const u = static_cast<double>(generator() >> 40) * 0x1p-24;
+        samples[j * m_m + i] =
+            static_cast<sample_type>(static_cast<double>(ref[i]) +
+                                     u * (approximation.upper - static_cast<double>(ref[i])));
+      }
+      m_key[j] = *std::max_element(samples.begin() + static_cast<std::ptrdiff_t>(j * m_m),
+                                   samples.begin() + static_cast<std::ptrdiff_t>(j * m_m + m_m));
+    }
+
+    // the samples are indexed by increasing largest objective
+    m_ids.resize(m_s);
+    for (std::size_t j = 0; j < m_s; ++j) {
+      m_ids[j] = static_cast<std::uint32_t>(j);
+    }
+    std::stable_sort(m_ids.begin(), m_ids.end(),
+                     [this](auto const a, auto const b) { return m_key[a] < m_key[b]; });
+    m_samples.resize(m_m * m_s);
+    std::vector<sample_type> key(m_s);
+    for (std::size_t j = 0; j < m_s; ++j) {
+      for (std::size_t i = 0; i < m_m; ++i) {
+        m_samples[i * m_s + j] = samples[m_ids[j] * m_m + i];
+      }
+      key[j] = m_key[m_ids[j]];
+      m_ids[j] = static_cast<std::uint32_t>(j);
+    }
+    m_key = std::move(key);
+    m_dominated.assign((m_s + 63) / 64, 0);
+    m_free = m_samples;
+    m_mask.resize(m_s);
+  }
+
+  /// Check if the estimate is enabled (i.e. samples were drawn)
+  [[nodiscard]] bool enabled() const noexcept {
+    return m_s != 0;
+  }
+
+  /// Get the approximation (the number of samples, the upper bound and the seed)
+  [[nodiscard]] hv_approximation const& approximation() const noexcept {
+    return m_approximation;
+  }
+
+  /// Get the estimate of the hypervolume
+  [[nodiscard]] hv_type value() const {
+    return m_volume * static_cast<hv_type>(m_s - m_left) / static_cast<hv_type>(m_s);
+  }
+
+  /**
+   * @brief Get the half-width of the confidence interval of the estimate (normal
+   *        approximation of the binomial proportion of the dominated samples).
+   *
+   * @param z The quantile of the standard normal distribution (1.96 for 95% confidence).
+   * @return hv_type The half-width of the interval around value().
+   */
+  [[nodiscard]] hv_type confidence(hv_type const z = 1.96) const {
+    auto const s = static_cast<hv_type>(m_s);
+    auto const p = static_cast<hv_type>(m_s - m_left) / s;
+    return z * m_volume * std::sqrt(p * (1 - p) / s);
+  }
+
+  /// Get the estimate of the contribution of a vector w.r.t. the samples dominated so far
+  /// (non-const, as it flags the samples in a workspace)
+  template <typename V>
+  [[nodiscard]] hv_type contribution(V const& v) {
+    return m_estimate(m_match(v, m_candidates(v)));
+  }
+
+  /// Mark the samples dominated by a vector and return the estimate of its contribution
+  template <typename V>
+  hv_type insert(V const& v) {
+    auto const candidates = m_candidates(v);
+    auto const count = m_match(v, candidates);
+    if (count == 0) {
+      return 0;
+    }
+
+    // the samples dominated stay in the packed arrays (but can not be dominated again) until
+    // they make up a quarter of them
+    for (std::size_t j = 0; j < candidates; ++j) {
+      if (m_mask[j]) {
+        m_dominated[m_ids[j] / 64] |= std::uint64_t(1) << (m_ids[j] % 64);
+        m_free[j] = std::numeric_limits<sample_type>::infinity();
+      }
+    }
+    m_left -= count;
+    if (4 * (m_ids.size() - m_left) > m_ids.size()) {
+      m_pack(m_free);
+    }
+    return m_estimate(count);
+  }
+
+  /**
+   * @brief Unmark the samples dominated by a removed vector and not by the vectors left, and
+   *        return the estimate of the contribution of the removed vector.
+   *
+   * @tparam V The type for the vector removed.
+   * @tparam S The type for the set of vectors left.
+   * @param v The vector removed.
+   * @param s The vectors left.
+   * @return hv_type The estimate of the contribution of the vector.
+   */
+  template <typename V, typename S>
+  hv_type remove(V const& v, S const& s) {
+    std::size_t count = 0;
+    for (std::size_t j = 0; j < m_s; ++j) {
+      if (!(m_dominated[j / 64] >> (j % 64) & 1) || !m_dominates(v, j) ||
+          std::any_of(s.begin(), s.end(), [this, j](auto const& q) { return m_dominates(q, j); })) {
+        continue;
+      }
+      m_dominated[j / 64] &= ~(std::uint64_t(1) << (j % 64));
+      ++count;
+    }
+    if (count == 0) {
+      return 0;
+    }
+
+    m_left += count;
+    m_ids.resize(m_s);
+    for (std::size_t j = 0; j < m_s; ++j) {
+      m_ids[j] = static_cast<std::uint32_t>(j);
+    }
+    m_pack(m_samples);
+    return m_estimate(count);
+  }
+
+ private:
+  /// Pack the samples left (in order), from the packed arrays or from the arrays of every sample
+  void m_pack(std::vector<sample_type> const& samples) {
+    std::size_t size = 0;
+    for (std::size_t j = 0; j < m_ids.size(); ++j) {
+      if (!(m_dominated[m_ids[j] / 64] >> (m_ids[j] % 64) & 1)) {
+        auto const k = &samples == &m_free ? j : m_ids[j];
+        for (std::size_t i = 0; i < m_m; ++i) {
+          m_free[i * m_s + size] = samples[i * m_s + k];
+        }
+        m_ids[size++] = m_ids[j];
+      }
+    }
+    m_ids.resize(size);
+  }
+
+  [[nodiscard]] hv_type m_estimate(std::size_t const count) const {
+    return m_volume * static_cast<hv_type>(count) / static_cast<hv_type>(m_s);
+  }
+
+  /// Check if a vector weakly dominates a sample
+  template <typename V>
+  [[nodiscard]] bool m_dominates(V const& v, std::size_t const j) const {
+    for (std::size_t i = 0; i < m_m; ++i) {
+      if (m_samples[i * m_s + j] > static_cast<sample_type>(v[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Get the number of samples left whose largest objective does not exceed the one of a
+  /// vector (the only ones it may dominate)
+  template <typename V>
+  [[nodiscard]] std::size_t m_candidates(V const& v) const {
+    sample_type largest = static_cast<sample_type>(v[0]);
+    for (std::size_t i = 1; i < m_m; ++i) {
+      largest = std::max(largest, static_cast<sample_type>(v[i]));
+    }
+    auto const it = std::upper_bound(m_ids.begin(), m_ids.end(), largest,
+                                     [this](auto const x, auto const j) { return x < m_key[j]; });
+    return static_cast<std::size_t>(it - m_ids.begin());
+  }
+
+  /// Flag (in the mask) the first samples left that a vector weakly dominates, and count them
+  template <typename V>
+  std::size_t m_match(V const& v, std::size_t const size) {
+    APMNKL_PROFILE_COUNT(comparisons, size);
+    auto* mask = m_mask.data();
+    auto const* free = m_free.data();
+    auto const v0 = static_cast<sample_type>(v[0]);
+    for (std::size_t j = 0; j < size; ++j) {
+      mask[j] = free[j] <= v0;
+    }
+    for (std::size_t i = 1; i < m_m; ++i) {
+      auto const vi = static_cast<sample_type>(v[i]);
+      auto const* objective = free + i * m_s;
+      for (std::size_t j = 0; j < size; ++j) {
+        mask[j] &= objective[j] <= vi;
+      }
+    }
+    std::size_t count = 0;
+    for (std::size_t j = 0; j < size; ++j) {
+      count += mask[j];
+    }
+    return count;
+  }
+
+  hv_approximation m_approximation;
+  std::size_t m_m = 0;
+  std::size_t m_s = 0;
+  // samples not dominated
+  std::size_t m_left = 0;
+  // volume of the box of the samples
+  hv_type m_volume = 0;
+  // the samples (one array of m_s values per objective, by increasing largest objective), their
+  // largest objective and the bitmap of the dominated ones
+  std::vector<sample_type> m_samples;
+  std::vector<sample_type> m_key;
+  std::vector<std::uint64_t> m_dominated;
+  // the samples left, and some dominated ones (packed, one array of m_s values per objective),
+  // and their indices
+  std::vector<sample_type> m_free;
+  std::vector<std::uint32_t> m_ids;
+  std::vector<std::uint8_t> m_mask;
+};
+}  // namespace priv
+}  // namespace apmnkl
+#endif  // HVMC_HPP
@@ -0,0 +1,252 @@
+/**
+ * @file population.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Structure-of-arrays storage of the population of a genetic algorithm: the objective
+ *        vectors in one contiguous (size x M) matrix, the fitness values in a dense array
+ *        and the decision vectors in a packed (size x words) bit matrix.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef POPULATION_HPP
+#define POPULATION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "bitset.hpp"
+#include "checkpoint.hpp"
+#include "solution.hpp"
+
+namespace apmnkl {
+
+namespace priv {
+
+/// Read-only view of an objective vector stored in a row of a matrix
+class objective_row {
+ public:
+  using value_type = double;
+
+  constexpr objective_row(double const *data, std::size_t const size) noexcept
+      : m_data(data)
+      , m_size(size) {}
+
+  [[nodiscard]] constexpr double const *data() const noexcept {
+    return m_data;
+  }
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept {
+    return m_size;
+  }
+
+  [[nodiscard]] constexpr double const *begin() const noexcept {
+    return m_data;
+  }
+
+  [[nodiscard]] constexpr double const *end() const noexcept {
+    return m_data + m_size;
+  }
+
+  [[nodiscard]] constexpr double operator[](std::size_t const i) const noexcept {
+    return m_data[i];
+  }
+
+ private:
+  double const *m_data;
+  std::size_t m_size;
+};
+
+/// Read-only view of an individual of a population (its objective vector and fitness value,
+/// i.e. what the indicators and the selection operators read from a gasolution)
+class individual_view {
+ public:
+  constexpr individual_view(objective_row const objv, double const fitness) noexcept
+      : m_objv(objv)
+      , m_fitness(fitness) {}
+
+  [[nodiscard]] constexpr objective_row const &objective_vector() const noexcept {
+    return m_objv;
+  }
+
+  [[nodiscard]] constexpr double fitness() const noexcept {
+    return m_fitness;
+  }
+
+ private:
+  objective_row m_objv;
+  double m_fitness;
+};
+
+/**
+ * @brief Population of a genetic algorithm stored as a structure of arrays, so the loops over
+ *        the objective vectors (of the fitness assignment, the objective bounds, ...) run
+ *        over contiguous memory, and removing an individual only swaps rows. The individuals
+ *        are accessed by index (see operator[] for a view of one of them).
+ */
+class population {
+ public:
+  using word_type = packed_bitset::word_type;
+
+  population() = default;
+
+  /**
+   * @brief Construct a new (empty) population object.
+   *
+   * @param M The number of objectives.
+   * @param N The number of bits of the decision vectors.
+   */
+  population(std::size_t const M, std::size_t const N)
+      : m_m(M)
+      , m_n(N)
+      , m_words(packed_bitset::words_for(N)) {}
+
+  /// Get the number of individuals
+  [[nodiscard]] std::size_t size() const noexcept {
+    return m_fitness.size();
+  }
+
+  [[nodiscard]] bool empty() const noexcept {
+    return m_fitness.empty();
+  }
+
+  /// Get the number of objectives
+  [[nodiscard]] std::size_t objectives() const noexcept {
+    return m_m;
+  }
+
+  /// Reserve the storage of a number of individuals
+  void reserve(std::size_t const capacity) {
+    m_objectives.reserve(capacity * m_m);
+    m_fitness.reserve(capacity);
+    m_decisions.reserve(capacity * m_words);
+  }
+
+  /// Discard every individual (keeping the storage)
+  void clear() noexcept {
+    m_objectives.clear();
+    m_fitness.clear();
+    m_decisions.clear();
+  }
+
+  /**
+   * @brief Append (a copy of) an evaluated solution.
+   *
+   * @param s The solution.
+   * @param fitness The fitness value of the individual.
+   */
+  void push_back(solution const &s, double const fitness = 0) {
+    m_objectives.insert(m_objectives.end(), s.objective_vector().begin(),
+                        s.objective_vector().end());
+    m_fitness.push_back(fitness);
+    m_decisions.insert(m_decisions.end(), s.decision_vector().data(),
+                       s.decision_vector().data() + m_words);
+  }
+
+  /// Remove the last individual
+  void pop_back() noexcept {
+    m_objectives.resize(m_objectives.size() - m_m);
+    m_fitness.pop_back();
+    m_decisions.resize(m_decisions.size() - m_words);
+  }
+
+  /// Swap two individuals
+  void swap(std::size_t const a, std::size_t const b) noexcept {
+    std::swap_ranges(m_objectives.begin() + static_cast<std::ptrdiff_t>(a * m_m),
+                     m_objectives.begin() + static_cast<std::ptrdiff_t>(a * m_m + m_m),
+                     m_objectives.begin() + static_cast<std::ptrdiff_t>(b * m_m));
+    std::swap(m_fitness[a], m_fitness[b]);
+    std::swap_ranges(m_decisions.begin() + static_cast<std::ptrdiff_t>(a * m_words),
+                     m_decisions.begin() + static_cast<std::ptrdiff_t>(a * m_words + m_words),
+                     m_decisions.begin() + static_cast<std::ptrdiff_t>(b * m_words));
+  }
+
+  /// Get a view of an individual (valid until the population is modified)
+  [[nodiscard]] individual_view operator[](std::size_t const i) const noexcept {
+    return individual_view(objective_vector(i), m_fitness[i]);
+  }
+
+  /// Get the objective vector of an individual
+  [[nodiscard]] objective_row objective_vector(std::size_t const i) const noexcept {
+    return objective_row(m_objectives.data() + i * m_m, m_m);
+  }
+
+  /// Get the objective matrix (size x M, row-major)
+  [[nodiscard]] std::vector<double> const &objective_matrix() const noexcept {
+    return m_objectives;
+  }
+
+  /// Get the fitness value of an individual
+  [[nodiscard]] double fitness(std::size_t const i) const noexcept {
+    return m_fitness[i];
+  }
+
+  /// Set the fitness value of an individual
+  void set_fitness(std::size_t const i, double const fitness) noexcept {
+    m_fitness[i] = fitness;
+  }
+
+  /// Get the fitness values (dense, in population order)
+  [[nodiscard]] std::vector<double> &fitness_values() noexcept {
+    return m_fitness;
+  }
+
+  /**
+   * @brief Copy the decision vector of an individual into a solution (reusing its storage),
+   *        e.g. to breed an offspring from it. The objective vector of the solution is left
+   *        as is, i.e. the solution has to be evaluated.
+   *
+   * @param i The index of the individual.
+   * @param s The solution receiving the decision vector.
+   */
+  void copy_decision(std::size_t const i, solution &s) const {
+    if (s.decision_vector().size() != m_n) {
+      s.decision_vector() = decision_vector(m_n);
+    }
+    std::copy_n(m_decisions.begin() + static_cast<std::ptrdiff_t>(i * m_words), m_words,
+                s.decision_vector().data());
+  }
+
+  /**
+   * @brief Save the population (its dimensions and matrices) into a checkpoint.
+   *
+   * @param writer The checkpoint writer.
+   */
+  void save(checkpoint_writer &writer) const {
+    writer.write(std::make_tuple(m_m, m_n));
+    writer.write(m_objectives);
+    writer.write(m_fitness);
+    writer.write(m_decisions);
+  }
+
+  /**
+   * @brief Load the population from a checkpoint.
+   *
+   * @param reader The checkpoint reader.
+   */
+  void load(checkpoint_reader &reader) {
+    auto dimensions = std::tie(m_m, m_n);
+    reader.read(dimensions);
+    m_words = packed_bitset::words_for(m_n);
+    reader.read(m_objectives);
+    reader.read(m_fitness);
+    reader.read(m_decisions);
+  }
+
+ private:
+  std::size_t m_m = 0;
+  std::size_t m_n = 0;
+  std::size_t m_words = 0;
+  std::vector<double> m_objectives;
+  std::vector<double> m_fitness;
+  std::vector<word_type> m_decisions;
+};
+}  // namespace priv
+}  // namespace apmnkl
+#endif  // POPULATION_HPP
@@ -0,0 +1,276 @@
+/**
+ * @file profile.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Optional instrumentation of the hot paths of the search heuristics: scoped timers of
+ *        the phases of the runs (evaluation, archive maintenance, hypervolume, IBEA fitness
+ *        assignment, ...) and counters. The instrumentation is only compiled in when
+ *        APMNKL_PROFILE is defined, otherwise the macros expand to nothing (zero cost).
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace apmnkl {
+
+/// Check if the instrumentation is compiled in (APMNKL_PROFILE defined)
+#ifdef APMNKL_PROFILE
+inline constexpr bool profile_enabled = true;
+#else
+inline constexpr bool profile_enabled = false;
+#endif
+
+namespace priv {
+
+/// Phases of the runs timed by the instrumentation
+enum class profile_phase : std::size_t {
+  evaluation,
+  archive,
+  hypervolume,
+  fitness_assignment,
+  environmental_selection,
+  selection,
+  crossover,
+  mutation
+};
+
+inline constexpr std::size_t profile_phases = 8;
+
+/// Counters of the instrumentation (the high-water marks keep the maximum value recorded)
+enum class profile_counter : std::size_t {
+  comparisons,       // dominance tests between two objective vectors
+  archive_size,      // high-water mark of the size of the sets of non-dominated solutions
+  wfg_depth,         // high-water mark of the depth of the WFG recursion
+  heap_allocations,  // heap allocations of the WFG workspaces
+};
+
+inline constexpr std::size_t profile_counters = 4;
+
+/// Profiling data (of a thread, or merged)
+struct profile_data {
+  std::array<std::uint64_t, profile_phases> calls{};
+  std::array<std::uint64_t, profile_phases> time{};
+  std::array<std::uint64_t, profile_counters> counters{};
+  // nesting of the scopes of each phase (only the outermost scope is timed)
+  std::array<unsigned, profile_phases> depth{};
+
+  /// Add the data of another thread
+  void merge(profile_data const &other) {
+    for (std::size_t p = 0; p < profile_phases; ++p) {
+      calls[p] += other.calls[p];
+      time[p] += other.time[p];
+    }
+    for (std::size_t c = 0; c < profile_counters; ++c) {
+      if (m_high_water(c)) {
+        counters[c] = std::max(counters[c], other.counters[c]);
+      } else {
+        counters[c] += other.counters[c];
+      }
+    }
+  }
+
+ private:
+  static constexpr bool m_high_water(std::size_t const c) {
+    return c == static_cast<std::size_t>(profile_counter::archive_size) ||
+           c == static_cast<std::size_t>(profile_counter::wfg_depth);
+  }
+};
+
+/**
+ * @brief Registry of the profiling data of the threads. Every thread records into its own
+ *        data (no synchronization in the hot paths), which is merged into the data of the
+ *        finished threads when the thread exits.
+ */
+class profile_registry {
+ public:
+  static profile_registry &instance() {
+    static profile_registry registry;
+    return registry;
+  }
+
+  void attach(profile_data *data) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_live.push_back(data);
+  }
+
+  void detach(profile_data *data) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_finished.merge(*data);
+    m_live.erase(std::find(m_live.begin(), m_live.end(), data));
+  }
+
+  /// Get the data of every thread (to be called once the runs are done)
+  [[nodiscard]] profile_data total() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto total = m_finished;
+    for (auto const *data : m_live) {
+      total.merge(*data);
+    }
+    return total;
+  }
+
+  /// Discard the data of every thread (to be called between the runs)
+  void reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_finished = profile_data();
+    for (auto *data : m_live) {
+      *data = profile_data();
+    }
+  }
+
+ private:
+  std::mutex m_mutex;
+  profile_data m_finished;
+  std::vector<profile_data *> m_live;
+};
+
+/// Profiling data of the calling thread
+inline profile_data &profile_local() {
+  struct thread_data {
+    profile_data data;
+
+    thread_data() {
+      profile_registry::instance().attach(&data);
+    }
+
+    ~thread_data() {
+      profile_registry::instance().detach(&data);
+    }
+  };
+  thread_local thread_data local;
+  return local.data;
+}
+
+/// Scoped timer of a phase (counting its calls)
+class profile_scope {
+ public:
+  explicit profile_scope(profile_phase const phase)
+      : m_data(profile_local())
+      , m_phase(static_cast<std::size_t>(phase)) {
+    ++m_data.calls[m_phase];
+    if (m_data.depth[m_phase]++ == 0) {
+      m_start = clock::now();
+    }
+  }
+
+  profile_scope(profile_scope const &) = delete;
+  profile_scope &operator=(profile_scope const &) = delete;
+
+  ~profile_scope() {
+    if (--m_data.depth[m_phase] == 0) {
+      auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() -
+                                                                                m_start);
+      m_data.time[m_phase] += static_cast<std::uint64_t>(elapsed.count());
+    }
+  }
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  profile_data &m_data;
+  std::size_t m_phase;
+  clock::time_point m_start;
+};
+
+/// Add to a counter
+inline void profile_count(profile_counter const counter, std::uint64_t const n = 1) {
+  profile_local().counters[static_cast<std::size_t>(counter)] += n;
+}
+
+/// Record a value of a high-water mark counter
+inline void profile_max(profile_counter const counter, std::uint64_t const value) {
+  auto &current = profile_local().counters[static_cast<std::size_t>(counter)];
+  current = std::max(current, value);
+}
+}  // namespace priv
+
+/// Discard the profiling data recorded so far
+inline void reset_profile() {
+  priv::profile_registry::instance().reset();
+}
+
+/**
+ * @brief Write the per-phase breakdown of the profiling data recorded so far: the calls and
+ *        time of each phase (the time of the phases of concurrent threads adds up, so the
+ *        shares of the run may exceed 100%) followed by the counters.
+ *
+ * @param os The output stream where the report should be written to.
+ * @param elapsed The wall-clock time of the runs profiled.
+ */
+inline void profile_report(std::ostream &os, std::chrono::nanoseconds const elapsed) {
+  static constexpr char const *phases[priv::profile_phases] = {
+      "evaluation", "archive",   "hypervolume", "fitness assignment", "environmental selection",
+      "selection",  "crossover", "mutation"};
+  static constexpr char const *counters[priv::profile_counters] = {
+      "comparisons", "archive size (max)", "wfg depth (max)", "heap allocations"};
+
+  auto const total = priv::profile_registry::instance().total();
+  auto const run = static_cast<double>(elapsed.count());
+  auto const flags = os.flags();
+  auto const precision = os.precision();
+
+  os << std::left << std::setw(26) << "phase" << std::right << std::setw(16) << "calls"
+     << std::setw(14) << "time (ms)" << std::setw(10) << "run (%)" << '\n';
+  double instrumented = 0;
+  for (std::size_t p = 0; p < priv::profile_phases; ++p) {
+    auto const time = static_cast<double>(total.time[p]);
+    instrumented += time;
+    os << std::left << std::setw(26) << phases[p] << std::right << std::setw(16)
+       << total.calls[p] << std::fixed << std::setprecision(3) << std::setw(14) << time / 1e6
+       << std::setprecision(1) << std::setw(10) << (run > 0 ? 100 * time / run : 0.0) << '\n';
+  }
+  os << std::left << std::setw(26) << "other" << std::right << std::setw(16) << "-"
+     << std::setprecision(3) << std::setw(14) << std::max(run - instrumented, 0.0) / 1e6
+     << std::setprecision(1) << std::setw(10)
+     << (run > 0 ? 100 * std::max(run - instrumented, 0.0) / run : 0.0) << "\n\n";
+
+  os << std::left << std::setw(26) << "counter" << std::right << std::setw(16) << "value"
+     << '\n';
+  for (std::size_t c = 0; c < priv::profile_counters; ++c) {
+    os << std::left << std::setw(26) << counters[c] << std::right << std::setw(16)
+       << total.counters[c] << '\n';
+  }
+
+  os.flags(flags);
+  os.precision(precision);
+}
+}  // namespace apmnkl
+
+#ifdef APMNKL_PROFILE
+#define APMNKL_PROFILE_CONCAT_(a, b) a##b
+#define APMNKL_PROFILE_CONCAT(a, b) APMNKL_PROFILE_CONCAT_(a, b)
+
+/// Time the rest of the enclosing scope as a phase (see apmnkl::priv::profile_phase)
+#define APMNKL_PROFILE_SCOPE(phase)                                         \
+  ::apmnkl::priv::profile_scope APMNKL_PROFILE_CONCAT(profile_, __LINE__) { \
+    ::apmnkl::priv::profile_phase::phase                                    \
+  }
+
+/// Add to a counter (see apmnkl::priv::profile_counter)
+#define APMNKL_PROFILE_COUNT(counter, n) \
+  ::apmnkl::priv::profile_count(::apmnkl::priv::profile_counter::counter, (n))
+
+/// Record a value of a high-water mark counter (see apmnkl::priv::profile_counter)
+#define APMNKL_PROFILE_MAX(counter, value) \
+  ::apmnkl::priv::profile_max(::apmnkl::priv::profile_counter::counter, (value))
+#else
+#define APMNKL_PROFILE_SCOPE(phase) static_cast<void>(0)
+#define APMNKL_PROFILE_COUNT(counter, n) static_cast<void>(0)
+#define APMNKL_PROFILE_MAX(counter, value) static_cast<void>(0)
+#endif
+#endif  // PROFILE_HPP
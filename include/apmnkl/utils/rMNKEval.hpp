@@ -29,6 +29,8 @@ Authors:
  *  in c++ style
  *
  *  rhoMNK-landscapes instances can be generated with the rmnkGenerator.R
+ *  (text format), and converted to the binary format described below
+ *  (see RMNKEval::save) which is memory-mapped with no parsing at all
  *
  *  More information on rhoMNK-landscapes, see original paper:
  *  Verel S., Liefooghe A., Jourdan L., Dhaenens C. "Analyzing the Effect of Objective Correlation
@@ -36,15 +38,64 @@ Authors:
  * Conference (LION 5), LNCS, p. , 2011.
  */
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define APMNKL_HAS_MMAP
+#endif
+
+#include "bitset.hpp"
+#include "profile.hpp"
+
 namespace apmnkl {
 
 namespace priv {
 
+/// move to a neighbor of a solution: one bit flipped (second == first), or two different bits
+struct NeighborMove {
+  unsigned first;
+  unsigned second;
+};
+
+/// objective vectors of a batch of neighbors, in a structure-of-arrays layout
+struct NeighborBatch {
+  // number of neighbors in the batch
+  std::size_t size = 0;
+
+  // objective n of the b-th neighbor at objectives[n * size + b]
+  std::vector<double> objectives;
+
+  // workspace: sigmas of the parent solution ([objective][i] when not interleaved)
+  std::vector<unsigned> sigmas;
+
+  // workspace: bits of the sigmas flipped by a two-bit move (kept zero between moves)
+  std::vector<unsigned> masks;
+
+  /*
+   * to get an objective value of a neighbor
+   *
+   * @param _numObj the objective function to consider
+   * @param _b      the index of the neighbor in the batch
+   * @return the objective value
+   */
+  double objective(unsigned _numObj, std::size_t _b) const {
+    return objectives[_numObj * size + _b];
+  }
+};
+
 /// rmnk_landscapes instance evaluator
 class RMNKEval {
  public:
@@ -60,41 +111,270 @@ class RMNKEval {
   /*
    *  Destructor
    */
-  virtual ~RMNKEval() {
-    if (links != NULL) {
-      for (unsigned int n = 0; n < M; n++) {
-        for (unsigned int i = 0; i < N; i++)
-          delete[](links[n][i]);
-        delete[] links[n];
-      }
+  virtual ~RMNKEval() = default;
+
+  /*
+   * Compute the fitness function
+   *
+   * The objective vector is filled in a single pass over the contributions.
+   * When the links are shared by every objective, one sigma computation gives
+   * access to the M (contiguous) contribution values at once.
+   *
+   * @param _solution the solution to evaluate
+   * @param _objVec   the objective vector of the corresponding solution
+   */
+  void eval(packed_bitset &_solution, std::vector<double> &_objVec) const {
+    APMNKL_PROFILE_SCOPE(evaluation);
+    (this->*evalKernel)(_solution, _objVec);
+  }
+
+  /*
+   * Flip one bit of a solution and update its objective vector incrementally
+   *
+   * Only the contributions whose links include the flipped bit are recomputed,
+   * which costs O(M (K+1)^2) instead of the O(M N (K+1)) of a full evaluation.
+   * As the contributions are stored on a common grid (see quantizeTables) the
+   * resulting objective vector is bit-identical to the one given by eval.
+   *
+   * @param _solution the solution to modify (flipped in place)
+   * @param _objVec   the objective vector of the solution before the flip (updated in place)
+   * @param _bit      the bit to flip
+   */
+  void evalFlip(packed_bitset &_solution, std::vector<double> &_objVec, unsigned _bit) const {
+    APMNKL_PROFILE_SCOPE(evaluation);
+    (this->*evalFlipKernel)(_solution, _objVec, _bit);
+  }
+
+  /*
+   * Evaluate a batch of one-bit-flip neighbors of a solution at once
+   *
+   * The sigmas of the solution are computed once, and the contributions of
+   * a neighbor are then looked up with its flipped bit applied to the sigmas
+   * (no extraction of links per neighbor). The solution itself is left
+   * unmodified, and the objective vectors are bit-identical to the ones
+   * given by evalFlip.
+   *
+   * @param _solution the solution whose neighbors are evaluated
+   * @param _objVec   the objective vector of the solution
+   * @param _bits     the flipped bit of each neighbor
+   * @param _batch    the objective vectors of the neighbors (reused between calls)
+   */
+  void evalNeighbors(packed_bitset const &_solution, std::vector<double> const &_objVec,
+                     std::vector<unsigned> const &_bits, NeighborBatch &_batch) const {
+    APMNKL_PROFILE_SCOPE(evaluation);
+    std::size_t count = _bits.size();
+    std::size_t entries = std::size_t(1) << (K + 1);
+    const double *t = tableData.get();
+
+    initBatch(_solution, _objVec, count, _batch);
 
-      delete[] links;
-      links = NULL;
+    if (interleaved) {
+      for (std::size_t b = 0; b < count; b++)
+        for (std::size_t k = bitContributionsOffset[_bits[b]];
+             k < bitContributionsOffset[_bits[b] + 1]; k++) {
+          unsigned i = bitContributions[k];
+          unsigned s = _batch.sigmas[i];
+          const double *before = t + (i * entries + s) * M;
+          const double *after = t + (i * entries + (s ^ bitContributionMasks[k])) * M;
+          for (unsigned n = 0; n < M; n++)
+            _batch.objectives[n * count + b] += after[n] - before[n];
+        }
+    } else {
+      for (unsigned n = 0; n < M; n++) {
+        const unsigned *sigmas = _batch.sigmas.data() + std::size_t(n) * N;
+        const double *objTable = t + std::size_t(n) * N * entries;
+        double *objValues = _batch.objectives.data() + n * count;
+        for (std::size_t b = 0; b < count; b++)
+          for (std::size_t k = bitContributionsOffset[n * N + _bits[b]];
+               k < bitContributionsOffset[n * N + _bits[b] + 1]; k++) {
+            unsigned i = bitContributions[k];
+            const double *contributions = objTable + i * entries;
+            objValues[b] +=
+                contributions[sigmas[i] ^ bitContributionMasks[k]] - contributions[sigmas[i]];
+          }
+      }
     }
+  }
+
+  /*
+   * Evaluate a batch of neighbors of a solution reached by one- or two-bit moves
+   *
+   * As in evalNeighbors, the sigmas of the solution are computed once. A
+   * two-bit move (e.g. a swap of two different bits) only recomputes the
+   * contributions whose links include one of its bits, the ones linked to
+   * both being looked up once with both bits applied to their sigma. The
+   * objective vectors are bit-identical to the ones given by evalFlips.
+   *
+   * @param _solution the solution whose neighbors are evaluated
+   * @param _objVec   the objective vector of the solution
+   * @param _moves    the move of each neighbor
+   * @param _batch    the objective vectors of the neighbors (reused between calls)
+   */
+  void evalMoves(packed_bitset const &_solution, std::vector<double> const &_objVec,
+                 std::vector<NeighborMove> const &_moves, NeighborBatch &_batch) const {
+    APMNKL_PROFILE_SCOPE(evaluation);
+    std::size_t count = _moves.size();
+    std::size_t entries = std::size_t(1) << (K + 1);
+    const double *t = tableData.get();
+
+    initBatch(_solution, _objVec, count, _batch);
+    _batch.masks.resize(_batch.sigmas.size());
+
+    if (interleaved) {
+      unsigned *masks = _batch.masks.data();
+      for (std::size_t b = 0; b < count; b++) {
+        unsigned bits[2] = {_moves[b].first, _moves[b].second};
+        unsigned flips = bits[0] == bits[1] ? 1 : 2;
+        for (unsigned f = 0; f < flips; f++)
+          for (std::size_t k = bitContributionsOffset[bits[f]];
+               k < bitContributionsOffset[bits[f] + 1]; k++)
+            masks[bitContributions[k]] ^= bitContributionMasks[k];
 
-    if (tables != NULL) {
-      for (unsigned int n = 0; n < M; n++) {
-        for (unsigned int i = 0; i < N; i++)
-          delete[](tables[n][i]);
-        delete[] tables[n];
+        for (unsigned f = 0; f < flips; f++)
+          for (std::size_t k = bitContributionsOffset[bits[f]];
+               k < bitContributionsOffset[bits[f] + 1]; k++) {
+            unsigned i = bitContributions[k];
+            if (masks[i] == 0)
+              continue;
+            unsigned s = _batch.sigmas[i];
+            const double *before = t + (i * entries + s) * M;
+            const double *after = t + (i * entries + (s ^ masks[i])) * M;
+            for (unsigned n = 0; n < M; n++)
+              _batch.objectives[n * count + b] += after[n] - before[n];
+            masks[i] = 0;
+          }
       }
+    } else {
+      for (unsigned n = 0; n < M; n++) {
+        const unsigned *sigmas = _batch.sigmas.data() + std::size_t(n) * N;
+        unsigned *masks = _batch.masks.data() + std::size_t(n) * N;
+        const double *objTable = t + std::size_t(n) * N * entries;
+        double *objValues = _batch.objectives.data() + n * count;
+        for (std::size_t b = 0; b < count; b++) {
+          unsigned bits[2] = {_moves[b].first, _moves[b].second};
+          unsigned flips = bits[0] == bits[1] ? 1 : 2;
+          for (unsigned f = 0; f < flips; f++)
+            for (std::size_t k = bitContributionsOffset[n * N + bits[f]];
+                 k < bitContributionsOffset[n * N + bits[f] + 1]; k++)
+              masks[bitContributions[k]] ^= bitContributionMasks[k];
 
-      delete tables;
-      tables = NULL;
+          for (unsigned f = 0; f < flips; f++)
+            for (std::size_t k = bitContributionsOffset[n * N + bits[f]];
+                 k < bitContributionsOffset[n * N + bits[f] + 1]; k++) {
+              unsigned i = bitContributions[k];
+              if (masks[i] == 0)
+                continue;
+              const double *contributions = objTable + i * entries;
+              objValues[b] += contributions[sigmas[i] ^ masks[i]] - contributions[sigmas[i]];
+              masks[i] = 0;
+            }
+        }
+      }
     }
   }
 
   /*
-   * Compute the fitness function
+   * Flip a list of bits of a solution and update its objective vector incrementally
    *
-   * @param _solution the solution to evaluate
-   * @param _objVec   the objective vector of the corresponding solution
+   * @param _solution the solution to modify (flipped in place)
+   * @param _objVec   the objective vector of the solution before the flips (updated in place)
+   * @param _bits     the bits to flip
    */
-  void eval(std::vector<bool> &_solution, std::vector<double> &_objVec) {
-    _objVec.resize(M);
+  void evalFlips(packed_bitset &_solution, std::vector<double> &_objVec,
+                 std::vector<unsigned> const &_bits) const {
+    for (unsigned bit : _bits)
+      evalFlip(_solution, _objVec, bit);
+  }
 
-    for (unsigned n = 0; n < M; n++)
-      _objVec[n] = evalNK(n, _solution);
+  /*
+   * Save the instance in the binary format, i.e. with the contributions
+   * already quantized and stored in the layout used by the evaluation
+   *
+   * @param _fileName file name of the binary instance
+   */
+  void save(const char *_fileName) const {
+    std::size_t linkCount = std::size_t(M) * N * (K + 1);
+    std::size_t tableCount = std::size_t(M) * N * (std::size_t(1) << (K + 1));
+
+    BinaryHeader header{};
+    std::memcpy(header.magic, binaryMagic, sizeof(header.magic));
+    header.version = binaryVersion;
+    header.M = M;
+    header.N = N;
+    header.K = K;
+    header.rho = rho;
+    header.interleaved = interleaved ? 1 : 0;
+    header.linksOffset = sizeof(BinaryHeader);
+    header.tablesOffset = (header.linksOffset + linkCount * sizeof(std::uint32_t) +
+                           binaryAlignment - 1) /
+                          binaryAlignment * binaryAlignment;
+
+    std::ofstream file(_fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      std::cerr << "Error RMNKEval.save: impossible to open file " << _fileName;
+      return;
+    }
+
+    std::vector<char> padding(
+        header.tablesOffset - header.linksOffset - linkCount * sizeof(std::uint32_t), 0);
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(BinaryHeader));
+    file.write(reinterpret_cast<const char *>(links.data()),
+               static_cast<std::streamsize>(linkCount * sizeof(std::uint32_t)));
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    file.write(reinterpret_cast<const char *>(tableData.get()),
+               static_cast<std::streamsize>(tableCount * sizeof(double)));
+
+    if (!file)
+      std::cerr << "Error RMNKEval.save: impossible to write file " << _fileName;
+  }
+
+  /*
+   * Read the parameters of an instance from the header of its file (text or
+   * binary), without loading its links and contributions (e.g. to estimate
+   * the cost of a run before loading the instance)
+   *
+   * @param _fileName file name of the instance
+   * @param _M number of objective functions (set if the header was read)
+   * @param _N size of the bit string (set if the header was read)
+   * @param _K number of interactions between variables (set if the header was read)
+   * @return true if the header of the instance was read
+   */
+  static bool readParameters(const char *_fileName, unsigned &_M, unsigned &_N, unsigned &_K) {
+    std::ifstream file(_fileName, std::ios::in | std::ios::binary);
+    BinaryHeader header{};
+
+    file.read(reinterpret_cast<char *>(&header), sizeof(BinaryHeader));
+    if (file && std::memcmp(header.magic, binaryMagic, sizeof(binaryMagic)) == 0) {
+      if (header.version != binaryVersion)
+        return false;
+      _M = header.M;
+      _N = header.N;
+      _K = header.K;
+      return true;
+    }
+
+    // text instance: the commentaries, then "p rMNK rho M N K"
+    file.clear();
+    file.seekg(0);
+    std::string s;
+    std::string line;
+    file >> s;
+    while (file && s[0] == 'c') {
+      getline(file, line, '\n');
+      file >> s;
+    }
+
+    std::string type;
+    double _rho;
+    unsigned m, n, k;
+    file >> type >> _rho >> m >> n >> k;
+    if (!file || s.compare("p") != 0 || type.compare("rMNK") != 0)
+      return false;
+    _M = m;
+    _N = n;
+    _K = k;
+    return true;
   }
 
   /*
@@ -102,7 +382,7 @@ class RMNKEval {
    *
    * @return dimension of the objective space
    */
-  unsigned getM() {
+  unsigned getM() const {
     return M;
   }
 
@@ -111,7 +391,7 @@ class RMNKEval {
    *
    * @return dimension of the bitstring
    */
-  unsigned getN() {
+  unsigned getN() const {
     return N;
   }
 
@@ -120,7 +400,7 @@ class RMNKEval {
    *
    * @return epistasis degree K
    */
-  unsigned getK() {
+  unsigned getK() const {
     return K;
   }
 
@@ -129,11 +409,50 @@ class RMNKEval {
    *
    * @return parameter rho
    */
-  double getRho() {
+  double getRho() const {
     return rho;
   }
 
+  /*
+   * to know if the contribution tables are stored objective-interleaved
+   * (i.e. if the links are identical for every objective function)
+   *
+   * @return true if the M values of a contribution are contiguous
+   */
+  bool isInterleaved() const {
+    return interleaved;
+  }
+
  protected:
+  /*
+   * Header of the binary instance format, followed by:
+   *  - at linksOffset:  the links, uint32 [objective][i][j]
+   *  - at tablesOffset: the contributions, double, already quantized and in
+   *                     the interleaved or objective-major layout
+   * Every value is stored in the byte order of the machine which wrote the
+   * file (a different byte order is detected through the version field).
+   */
+  struct BinaryHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t M;
+    std::uint32_t N;
+    std::uint32_t K;
+    double rho;
+    std::uint32_t interleaved;
+    std::uint32_t reserved;
+    std::uint64_t linksOffset;
+    std::uint64_t tablesOffset;
+    std::uint64_t padding;
+  };
+
+  static_assert(sizeof(BinaryHeader) == 64, "unexpected binary header size");
+  static_assert(sizeof(unsigned) == sizeof(std::uint32_t), "links are stored as uint32");
+
+  static constexpr char binaryMagic[8] = {'r', 'M', 'N', 'K', 'b', 'i', 'n', '\0'};
+  static constexpr std::uint32_t binaryVersion = 1;
+  static constexpr std::size_t binaryAlignment = 64;
+
   // correlation between contributions
   double rho;
 
@@ -146,11 +465,70 @@ class RMNKEval {
   // number of interactions between variables (epistasis)
   unsigned K;
 
-  // the M tables of contributions
-  double ***tables;
+  // the M tables of contributions, in a single contiguous read-only block
+  // (owned, or memory-mapped from a binary instance) shared by the copies
+  // of the evaluator:
+  //  - interleaved:      [i][sigma][objective]
+  //  - objective-major:  [objective][i][sigma]
+  std::shared_ptr<const double> tableData;
+
+  // the tables of contributions while a text instance is being loaded
+  std::vector<double> tables;
+
+  // the M links description, in a single contiguous block: [objective][i][j]
+  std::vector<unsigned> links;
+
+  // true if the links are identical for every objective (interleaved tables)
+  bool interleaved;
+
+  // for each objective and bit (or only for each bit when interleaved), the
+  // contributions whose links include that bit, delimited by bitContributionsOffset,
+  // and the bits of their sigma which depend on that bit
+  std::vector<unsigned> bitContributions;
+  std::vector<unsigned> bitContributionMasks;
+  std::vector<std::size_t> bitContributionsOffset;
+
+  // the evaluation kernels selected for the shape of the instance
+  void (RMNKEval::*evalKernel)(packed_bitset &, std::vector<double> &) const;
+  void (RMNKEval::*evalFlipKernel)(packed_bitset &, std::vector<double> &, unsigned) const;
+
+  /***********************************************
+   *
+   * Read the contribution of the (_numObj, _i, _sigma) entry
+   *
+   ***********************************************/
+  const double &contribution(unsigned _numObj, unsigned _i, unsigned _sigma) const {
+    std::size_t entries = std::size_t(1) << (K + 1);
+    if (interleaved)
+      return tableData.get()[(_i * entries + _sigma) * M + _numObj];
+    return tableData.get()[(std::size_t(_numObj) * N + _i) * entries + _sigma];
+  }
+
+  /***********************************************
+   *
+   * Access the contribution of the (_numObj, _i, _sigma) entry while a text
+   * instance is being loaded
+   *
+   ***********************************************/
+  double &table(unsigned _numObj, unsigned _i, unsigned _sigma) {
+    std::size_t entries = std::size_t(1) << (K + 1);
+    if (interleaved)
+      return tables[(_i * entries + _sigma) * M + _numObj];
+    return tables[(std::size_t(_numObj) * N + _i) * entries + _sigma];
+  }
+
+  /***********************************************
+   *
+   * Access the j-th link of the contribution (_numObj, _i)
+   *
+   ***********************************************/
+  unsigned &link(unsigned _numObj, unsigned _i, unsigned _j) {
+    return links[(std::size_t(_numObj) * N + _i) * (K + 1) + _j];
+  }
 
-  // the M links description
-  unsigned ***links;
+  const unsigned &link(unsigned _numObj, unsigned _i, unsigned _j) const {
+    return links[(std::size_t(_numObj) * N + _i) * (K + 1) + _j];
+  }
 
   /***********************************************
    *
@@ -160,6 +538,11 @@ class RMNKEval {
    *
    ***********************************************/
   virtual void load(const char *_fileName) {
+    if (isBinary(_fileName)) {
+      loadBinary(_fileName);
+      return;
+    }
+
     std::fstream file;
     file.open(_fileName, std::ios::in);
 
@@ -217,6 +600,12 @@ class RMNKEval {
         std::cerr << "Error RMNKEval.load: line with \"tables\" expected at " + s + " in "
                   << _fileName;
 
+      initLayout();
+      quantizeTables();
+      publishTables();
+      initBitContributions();
+      selectKernels();
+
       file.close();
     } else
       std::cerr << "Error RMNKEval.load: impossible to open file " << _fileName;
@@ -224,22 +613,139 @@ class RMNKEval {
 
   /***********************************************
    *
-   * Initialization of the different tables and epistasis links
+   * Check if a file is a binary rMNK-landscapes instance
+   *
+   * @param _fileName file name of the instance
    *
    ***********************************************/
-  void init() {
-    links = new unsigned **[M];
-    tables = new double **[M];
+  bool isBinary(const char *_fileName) {
+    std::ifstream file(_fileName, std::ios::in | std::ios::binary);
+    char magic[sizeof(binaryMagic)] = {};
 
-    for (unsigned n = 0; n < M; n++) {
-      links[n] = new unsigned *[N];
-      tables[n] = new double *[N];
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, binaryMagic, sizeof(magic)) == 0;
+  }
 
-      for (unsigned i = 0; i < N; i++) {
-        tables[n][i] = new double[1 << (K + 1)];
-        links[n][i] = new unsigned[K + 1];
-      }
+  /***********************************************
+   *
+   * Load a binary rMNK-landscapes instance: the file is memory-mapped and the
+   * contributions are used in place (no parsing, no copy), so the processes
+   * which load the same instance share a single copy of it in page cache
+   *
+   * @param _fileName file name of the binary instance
+   *
+   ***********************************************/
+  void loadBinary(const char *_fileName) {
+    std::size_t size = 0;
+    std::shared_ptr<const char> file = mapFile(_fileName, size);
+
+    if (!file) {
+      std::cerr << "Error RMNKEval.load: impossible to open file " << _fileName;
+      return;
+    }
+
+    BinaryHeader header;
+    std::memcpy(&header, file.get(), sizeof(BinaryHeader));
+
+    if (header.version != binaryVersion) {
+      std::cerr << "Error RMNKEval.load: unsupported binary version (or byte order) in "
+                << _fileName;
+      return;
     }
+
+    rho = header.rho;
+    M = header.M;
+    N = header.N;
+    K = header.K;
+    interleaved = header.interleaved != 0;
+
+    std::size_t linkCount = std::size_t(M) * N * (K + 1);
+    std::size_t tableCount = std::size_t(M) * N * (std::size_t(1) << (K + 1));
+
+    if (header.linksOffset + linkCount * sizeof(std::uint32_t) > size ||
+        header.tablesOffset % alignof(double) != 0 ||
+        header.tablesOffset + tableCount * sizeof(double) > size) {
+      std::cerr << "Error RMNKEval.load: truncated binary instance " << _fileName;
+      return;
+    }
+
+    links.resize(linkCount);
+    std::memcpy(links.data(), file.get() + header.linksOffset,
+                linkCount * sizeof(std::uint32_t));
+
+    tables.clear();
+    tableData = std::shared_ptr<const double>(
+        file, static_cast<const double *>(
+                  static_cast<const void *>(file.get() + header.tablesOffset)));
+
+    initBitContributions();
+    selectKernels();
+  }
+
+  /***********************************************
+   *
+   * Map a whole file in memory (read-only), or read it when memory mapping
+   * is not available
+   *
+   * @param _fileName file name
+   * @param _size     size of the file (output)
+   * @return the mapped file (nullptr on failure), unmapped with its last copy
+   *
+   ***********************************************/
+  std::shared_ptr<const char> mapFile(const char *_fileName, std::size_t &_size) {
+#ifdef APMNKL_HAS_MMAP
+    int fd = ::open(_fileName, O_RDONLY);
+    if (fd < 0)
+      return nullptr;
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0 || status.st_size < std::int64_t(sizeof(BinaryHeader))) {
+      ::close(fd);
+      return nullptr;
+    }
+
+    std::size_t size = static_cast<std::size_t>(status.st_size);
+    void *address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED)
+      return nullptr;
+
+    _size = size;
+    return std::shared_ptr<const char>(static_cast<const char *>(address), [size](const char *_p) {
+      ::munmap(const_cast<char *>(_p), size);
+    });
+#else
+    std::ifstream file(_fileName, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+      return nullptr;
+
+    std::size_t size = static_cast<std::size_t>(file.tellg());
+    if (size < sizeof(BinaryHeader))
+      return nullptr;
+
+    // stored as doubles for the alignment of the contributions
+    auto buffer =
+        std::make_shared<std::vector<double>>((size + sizeof(double) - 1) / sizeof(double));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(buffer->data()), static_cast<std::streamsize>(size));
+    if (!file)
+      return nullptr;
+
+    _size = size;
+    return std::shared_ptr<const char>(buffer, reinterpret_cast<const char *>(buffer->data()));
+#endif
+  }
+
+  /***********************************************
+   *
+   * Initialization of the different tables and epistasis links
+   *
+   ***********************************************/
+  void init() {
+    links.assign(std::size_t(M) * N * (K + 1), 0);
+    tables.assign(std::size_t(M) * N * (std::size_t(1) << (K + 1)), 0.0);
+    interleaved = true;
   }
 
   /***********************************************
@@ -255,24 +761,314 @@ class RMNKEval {
     for (i = 0; i < N; i++)
       for (j = 0; j < K + 1; j++)
         for (n = 0; n < M; n++)
-          _file >> links[n][i][j];
+          _file >> link(n, i, j);
   }
 
   /***********************************************
    *
-   * Load the tables of contribution
+   * Load the tables of contribution (the file order is the interleaved one)
    *
    * @param _file open file of the instance
    *
    ***********************************************/
   void loadTables(std::fstream &_file) {
-    unsigned n, i;
-    int j;
+    for (double &contribution : tables)
+      _file >> contribution;
+  }
 
-    for (i = 0; i < N; i++)
-      for (j = 0; j < (1 << (K + 1)); j++)
-        for (n = 0; n < M; n++)
-          _file >> tables[n][i][j];
+  /***********************************************
+   *
+   * Choose the layout of the tables: keep them objective-interleaved if the
+   * links are identical for every objective, otherwise store them
+   * objective-major (each objective computes its own sigma)
+   *
+   ***********************************************/
+  void initLayout() {
+    for (unsigned n = 1; n < M && interleaved; n++)
+      interleaved = std::equal(&link(n, 0, 0), &link(n, 0, 0) + std::size_t(N) * (K + 1),
+                               &link(0, 0, 0));
+
+    if (!interleaved) {
+      std::vector<double> fileOrder;
+      fileOrder.swap(tables);
+      tables.resize(fileOrder.size());
+
+      std::size_t entries = std::size_t(1) << (K + 1);
+      for (unsigned i = 0; i < N; i++)
+        for (unsigned j = 0; j < entries; j++)
+          for (unsigned n = 0; n < M; n++)
+            table(n, i, j) = fileOrder[(i * entries + j) * M + n];
+    }
+  }
+
+  /***********************************************
+   *
+   * Divide the contributions by N and round them to a common grid
+   *
+   * The grid step is chosen such that every partial sum of contributions of
+   * an objective is exactly representable, hence objective values do not
+   * depend on the order (or incrementality) of the summation.
+   *
+   * Note that the objective values may differ in their last bits from the
+   * ones of earlier versions, which summed the contributions as read and
+   * divided the sum by N (e.g. 0.47241308343750005 becomes
+   * 0.47241308343749977). The runs of the search heuristics, and their
+   * anytime data, may diverge accordingly for the same seed and instance,
+   * so traces produced by those versions are not reproduced exactly.
+   *
+   ***********************************************/
+  void quantizeTables() {
+    unsigned entries = 1u << (K + 1);
+
+    for (unsigned n = 0; n < M; n++) {
+      double bound = 0.0;
+      for (unsigned i = 0; i < N; i++) {
+        double largest = 0.0;
+        for (unsigned j = 0; j < entries; j++)
+          largest = std::max(largest, std::abs(table(n, i, j)));
+        bound += largest / static_cast<double>(N);
+      }
+
+      int exponent;
+      std::frexp(bound, &exponent);
+      double step = std::ldexp(1.0, exponent - 52);
+
+      for (unsigned i = 0; i < N; i++)
+        for (unsigned j = 0; j < entries; j++)
+          table(n, i, j) = std::nearbyint(table(n, i, j) / static_cast<double>(N) / step) * step;
+    }
+  }
+
+  /***********************************************
+   *
+   * Move the loaded tables of contributions to their shared read-only block
+   *
+   ***********************************************/
+  void publishTables() {
+    auto owner = std::make_shared<std::vector<double>>(std::move(tables));
+    tables.clear();
+    tableData = std::shared_ptr<const double>(owner, owner->data());
+  }
+
+  /***********************************************
+   *
+   * Build, for each objective (only once when interleaved), the reverse
+   * index from bits to the contributions whose links include them
+   *
+   ***********************************************/
+  void initBitContributions() {
+    unsigned objectives = interleaved ? 1 : M;
+
+    std::vector<std::vector<unsigned>> contributions(std::size_t(objectives) * N);
+    std::vector<std::vector<unsigned>> masks(std::size_t(objectives) * N);
+    for (unsigned n = 0; n < objectives; n++)
+      for (unsigned i = 0; i < N; i++)
+        for (unsigned j = 0; j < K + 1; j++) {
+          std::size_t b = std::size_t(n) * N + link(n, i, j);
+          if (contributions[b].empty() || contributions[b].back() != i) {
+            contributions[b].push_back(i);
+            masks[b].push_back(0);
+          }
+          masks[b].back() |= 1u << j;
+        }
+
+    bitContributions.clear();
+    bitContributionMasks.clear();
+    bitContributionsOffset.assign(1, 0);
+    for (std::size_t b = 0; b < contributions.size(); b++) {
+      bitContributions.insert(bitContributions.end(), contributions[b].begin(),
+                              contributions[b].end());
+      bitContributionMasks.insert(bitContributionMasks.end(), masks[b].begin(), masks[b].end());
+      bitContributionsOffset.push_back(bitContributions.size());
+    }
+  }
+
+  /***********************************************
+   *
+   * Fitness function, runtime-generic version (any M, N, K and layout)
+   *
+   * @param _solution the solution to evaluate
+   * @param _objVec   the objective vector of the corresponding solution
+   *
+   ***********************************************/
+  void evalGeneric(packed_bitset &_solution, std::vector<double> &_objVec) const {
+    _objVec.assign(M, 0.0);
+
+    if (interleaved) {
+      for (unsigned i = 0; i < N; i++) {
+        const double *contributions = &contribution(0, i, sigma(0, _solution, i));
+        for (unsigned n = 0; n < M; n++)
+          _objVec[n] += contributions[n];
+      }
+    } else {
+      for (unsigned i = 0; i < N; i++)
+        for (unsigned n = 0; n < M; n++)
+          _objVec[n] += contribution(n, i, sigma(n, _solution, i));
+    }
+  }
+
+  /***********************************************
+   *
+   * Incremental evaluation of a bit flip, runtime-generic version
+   *
+   * @param _solution the solution to modify (flipped in place)
+   * @param _objVec   the objective vector of the solution before the flip (updated in place)
+   * @param _bit      the bit to flip
+   *
+   ***********************************************/
+  void evalFlipGeneric(packed_bitset &_solution, std::vector<double> &_objVec,
+                       unsigned _bit) const {
+    if (interleaved) {
+      const unsigned *first = bitContributions.data() + bitContributionsOffset[_bit];
+      const unsigned *last = bitContributions.data() + bitContributionsOffset[_bit + 1];
+
+      for (const unsigned *i = first; i != last; i++) {
+        const double *contributions = &contribution(0, *i, sigma(0, _solution, *i));
+        for (unsigned n = 0; n < M; n++)
+          _objVec[n] -= contributions[n];
+      }
+
+      _solution.flip(_bit);
+
+      for (const unsigned *i = first; i != last; i++) {
+        const double *contributions = &contribution(0, *i, sigma(0, _solution, *i));
+        for (unsigned n = 0; n < M; n++)
+          _objVec[n] += contributions[n];
+      }
+    } else {
+      for (unsigned n = 0; n < M; n++)
+        for (std::size_t k = bitContributionsOffset[n * N + _bit];
+             k < bitContributionsOffset[n * N + _bit + 1]; k++)
+          _objVec[n] -=
+              contribution(n, bitContributions[k], sigma(n, _solution, bitContributions[k]));
+
+      _solution.flip(_bit);
+
+      for (unsigned n = 0; n < M; n++)
+        for (std::size_t k = bitContributionsOffset[n * N + _bit];
+             k < bitContributionsOffset[n * N + _bit + 1]; k++)
+          _objVec[n] +=
+              contribution(n, bitContributions[k], sigma(n, _solution, bitContributions[k]));
+    }
+  }
+
+  /***********************************************
+   *
+   * Fitness function specialized for a fixed shape (interleaved layout only):
+   * every loop bound is a compile-time constant and the objective vector is
+   * accumulated in a std::array
+   *
+   * @param _solution the solution to evaluate
+   * @param _objVec   the objective vector of the corresponding solution
+   *
+   ***********************************************/
+  template <unsigned FM, unsigned FN, unsigned FK>
+  void evalFixed(packed_bitset &_solution, std::vector<double> &_objVec) const {
+    const packed_bitset::word_type *words = _solution.data();
+    std::array<double, FM> accu{};
+
+    for (unsigned i = 0; i < FN; i++) {
+      const double *contributions =
+          &tableData.get()[((std::size_t(i) << (FK + 1)) + sigmaFixed<FK>(words, i)) * FM];
+      for (unsigned n = 0; n < FM; n++)
+        accu[n] += contributions[n];
+    }
+
+    _objVec.assign(accu.begin(), accu.end());
+  }
+
+  /***********************************************
+   *
+   * Incremental evaluation of a bit flip specialized for a fixed shape
+   * (interleaved layout only)
+   *
+   * @param _solution the solution to modify (flipped in place)
+   * @param _objVec   the objective vector of the solution before the flip (updated in place)
+   * @param _bit      the bit to flip
+   *
+   ***********************************************/
+  template <unsigned FM, unsigned FN, unsigned FK>
+  void evalFlipFixed(packed_bitset &_solution, std::vector<double> &_objVec, unsigned _bit) const {
+    const unsigned *first = bitContributions.data() + bitContributionsOffset[_bit];
+    const unsigned *last = bitContributions.data() + bitContributionsOffset[_bit + 1];
+    const packed_bitset::word_type *words = _solution.data();
+    std::array<double, FM> accu;
+    std::copy(_objVec.begin(), _objVec.begin() + FM, accu.begin());
+
+    for (const unsigned *i = first; i != last; i++) {
+      const double *contributions =
+          &tableData.get()[((std::size_t(*i) << (FK + 1)) + sigmaFixed<FK>(words, *i)) * FM];
+      for (unsigned n = 0; n < FM; n++)
+        accu[n] -= contributions[n];
+    }
+
+    _solution.flip(_bit);
+
+    for (const unsigned *i = first; i != last; i++) {
+      const double *contributions =
+          &tableData.get()[((std::size_t(*i) << (FK + 1)) + sigmaFixed<FK>(words, *i)) * FM];
+      for (unsigned n = 0; n < FM; n++)
+        accu[n] += contributions[n];
+    }
+
+    std::copy(accu.begin(), accu.end(), _objVec.begin());
+  }
+
+  /***********************************************
+   *
+   * Extract epistatic links of the fitness contribution i (fixed K, shared links)
+   *
+   * @param _words the words of the solution to evaluate
+   * @param _i bit of the contribution
+   *
+   * **********************************************/
+  template <unsigned FK>
+  unsigned int sigmaFixed(const packed_bitset::word_type *_words, unsigned _i) const {
+    const unsigned *l = &links[std::size_t(_i) * (FK + 1)];
+    unsigned int accu = 0;
+
+    for (unsigned int j = 0; j < FK + 1; j++) {
+      packed_bitset::word_type bit =
+          (_words[l[j] / packed_bitset::word_bits] >> (l[j] % packed_bitset::word_bits)) & 1;
+      accu |= unsigned(bit) << j;
+    }
+
+    return accu;
+  }
+
+  /***********************************************
+   *
+   * Use the kernels specialized for the (FM, FN, FK) shape if it is the one
+   * of the loaded instance
+   *
+   * @return true if the specialized kernels were selected
+   *
+   ***********************************************/
+  template <unsigned FM, unsigned FN, unsigned FK>
+  bool selectFixedKernels() {
+    if (!interleaved || M != FM || N != FN || K != FK)
+      return false;
+
+    evalKernel = &RMNKEval::evalFixed<FM, FN, FK>;
+    evalFlipKernel = &RMNKEval::evalFlipFixed<FM, FN, FK>;
+    return true;
+  }
+
+  /***********************************************
+   *
+   * Select the evaluation kernels: the shapes of the production sweeps
+   * (M in {2, 3, 5, 7}, N = 128, K in {1, 8}) have compile-time specialized
+   * kernels, every other shape uses the runtime-generic ones
+   *
+   ***********************************************/
+  void selectKernels() {
+    evalKernel = &RMNKEval::evalGeneric;
+    evalFlipKernel = &RMNKEval::evalFlipGeneric;
+
+    selectFixedKernels<2, 128, 1>() || selectFixedKernels<3, 128, 1>() ||
+        selectFixedKernels<5, 128, 1>() || selectFixedKernels<7, 128, 1>() ||
+        selectFixedKernels<2, 128, 8>() || selectFixedKernels<3, 128, 8>() ||
+        selectFixedKernels<5, 128, 8>() || selectFixedKernels<7, 128, 8>();
   }
 
   /***********************************************
@@ -283,13 +1079,13 @@ class RMNKEval {
    * @param _sol the solution to evaluate
    *
    ***********************************************/
-  double evalNK(unsigned _numObj, std::vector<bool> &_sol) {
+  double evalNK(unsigned _numObj, packed_bitset &_sol) const {
     double accu = 0.0;
 
     for (unsigned int i = 0; i < N; i++)
-      accu += tables[_numObj][i][sigma(_numObj, _sol, static_cast<int>(i))];
+      accu += contribution(_numObj, i, sigma(_numObj, _sol, i));
 
-    return accu / static_cast<double>(N);
+    return accu;
   }
 
   /***********************************************
@@ -301,12 +1097,14 @@ class RMNKEval {
    * @param _i bit of the contribution
    *
    * **********************************************/
-  unsigned int sigma(unsigned _numObj, std::vector<bool> &_sol, int _i) {
+  unsigned int sigma(unsigned _numObj, packed_bitset const &_sol, unsigned _i) const {
+    const unsigned *l = &link(_numObj, _i, 0);
+    const packed_bitset::word_type *words = _sol.data();
     unsigned int n = 1;
     unsigned int accu = 0;
 
     for (unsigned int j = 0; j < K + 1; j++) {
-      if (_sol[links[_numObj][_i][j]] == 1)
+      if ((words[l[j] / packed_bitset::word_bits] >> (l[j] % packed_bitset::word_bits)) & 1)
         accu = accu | n;
 
       n = n << 1;
@@ -314,6 +1112,33 @@ class RMNKEval {
 
     return accu;
   }
+
+  /***********************************************
+   *
+   * Prepare a batch of neighbors of a solution: compute the sigmas of the
+   * solution and start every objective vector from the one of the solution
+   *
+   * @param _solution the solution whose neighbors are evaluated
+   * @param _objVec   the objective vector of the solution
+   * @param _count    the number of neighbors
+   * @param _batch    the batch of neighbors
+   *
+   ***********************************************/
+  void initBatch(packed_bitset const &_solution, std::vector<double> const &_objVec,
+                 std::size_t _count, NeighborBatch &_batch) const {
+    unsigned objectives = interleaved ? 1 : M;
+
+    _batch.size = _count;
+    _batch.objectives.resize(std::size_t(M) * _count);
+    _batch.sigmas.resize(std::size_t(objectives) * N);
+
+    for (unsigned n = 0; n < objectives; n++)
+      for (unsigned i = 0; i < N; i++)
+        _batch.sigmas[std::size_t(n) * N + i] = sigma(n, _solution, i);
+
+    for (unsigned n = 0; n < M; n++)
+      std::fill_n(_batch.objectives.begin() + std::ptrdiff_t(n * _count), _count, _objVec[n]);
+  }
 };
 
 }  // namespace priv
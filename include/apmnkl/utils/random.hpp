@@ -0,0 +1,199 @@
+/**
+ * @file random.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Fast pseudo random generator (xoshiro256**, with jump-ahead to split independent
+ *        streams) and batched random bit generation for the genetic operators.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <type_traits>
+
+namespace apmnkl {
+
+/**
+ * @brief xoshiro256** pseudo random generator (Blackman and Vigna), a drop-in replacement of
+ *        std::mt19937 for the operators (a UniformRandomBitGenerator of 64-bit values, with
+ *        the seeding, comparison and stream operators of the standard engines). Its 2^256 - 1
+ *        period is split into independent streams by jumping ahead: jump() advances it by
+ *        2^128 draws and long_jump() by 2^192 draws.
+ */
+class xoshiro256ss {
+ public:
+  using result_type = std::uint64_t;
+
+  static constexpr result_type default_seed = 5489u;
+
+  xoshiro256ss() noexcept
+      : xoshiro256ss(default_seed) {}
+
+  /// Construct a new xoshiro256ss object, its state expanded from a seed by splitmix64
+  explicit xoshiro256ss(result_type const value) noexcept {
+    seed(value);
+  }
+
+  /// Construct a new xoshiro256ss object, its state generated by a seed sequence
+  template <typename Sseq,
+            typename = std::enable_if_t<!std::is_convertible_v<Sseq, result_type>>>
+  explicit xoshiro256ss(Sseq &sequence) {
+    seed(sequence);
+  }
+
+  static constexpr result_type min() noexcept {
+    return 0;
+  }
+
+  static constexpr result_type max() noexcept {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /// Seed the generator (its state expanded from the seed by splitmix64)
+  void seed(result_type value = default_seed) noexcept {
+    for (auto &word : m_state) {
+      value += 0x9e3779b97f4a7c15u;
+      auto z = value;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  /// Seed the generator (its state generated by a seed sequence, never all zero)
+  template <typename Sseq,
+            typename = std::enable_if_t<!std::is_convertible_v<Sseq, result_type>>>
+  void seed(Sseq &sequence) {
+    std::array<std::uint32_t, 8> words;
+    sequence.generate(words.begin(), words.end());
+    for (std::size_t i = 0; i < m_state.size(); ++i) {
+      m_state[i] = std::uint64_t(words[2 * i]) << 32 | words[2 * i + 1];
+    }
+    if (m_state == state_type{}) {
+      m_state[0] = 1;
+    }
+  }
+
+  result_type operator()() noexcept {
+    auto const result = m_rotl(m_state[1] * 5, 7) * 9;
+    auto const t = m_state[1] << 17;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = m_rotl(m_state[3], 45);
+    return result;
+  }
+
+  /// Advance the generator by a number of draws
+  void discard(unsigned long long count) noexcept {
+    for (; count != 0; --count) {
+      (*this)();
+    }
+  }
+
+  /// Advance the generator by 2^128 draws (the start of the next of 2^128 streams)
+  void jump() noexcept {
+    m_jump({0x180ec6d33cfd0abau, 0xd5a61266f0c9392cu, 0xa9582618e03fc9aau, 0x39abdc4529b1661cu});
+  }
+
+  /// Advance the generator by 2^192 draws (the start of the next of 2^64 groups of streams)
+  void long_jump() noexcept {
+    m_jump({0x76e15d3efefdcbbfu, 0xc5004e441c522fb3u, 0x77710069854ee241u, 0x39109bb02acbe635u});
+  }
+
+  friend bool operator==(xoshiro256ss const &lhs, xoshiro256ss const &rhs) noexcept {
+    return lhs.m_state == rhs.m_state;
+  }
+
+  friend bool operator!=(xoshiro256ss const &lhs, xoshiro256ss const &rhs) noexcept {
+    return !(lhs == rhs);
+  }
+
+  /// Write the state of the generator (its four words, separated by spaces)
+  friend std::ostream &operator<<(std::ostream &os, xoshiro256ss const &generator) {
+    auto const flags = os.flags();
+    os.flags(std::ios_base::dec | std::ios_base::left);
+    os << generator.m_state[0] << ' ' << generator.m_state[1] << ' ' << generator.m_state[2]
+       << ' ' << generator.m_state[3];
+    os.flags(flags);
+    return os;
+  }
+
+  /// Read the state of the generator
+  friend std::istream &operator>>(std::istream &is, xoshiro256ss &generator) {
+    state_type state;
+    auto const flags = is.flags();
+    is.flags(std::ios_base::dec | std::ios_base::skipws);
+    is >> state[0] >> state[1] >> state[2] >> state[3];
+    is.flags(flags);
+    if (is) {
+      generator.m_state = state;
+    }
+    return is;
+  }
+
+ private:
+  using state_type = std::array<std::uint64_t, 4>;
+
+  static constexpr std::uint64_t m_rotl(std::uint64_t const x, int const k) noexcept {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  void m_jump(state_type const &polynomial) noexcept {
+    state_type state{};
+    for (auto const word : polynomial) {
+      for (int b = 0; b < 64; ++b) {
+        if (word & std::uint64_t(1) << b) {
+          for (std::size_t i = 0; i < state.size(); ++i) {
+            state[i] ^= m_state[i];
+          }
+        }
+        (*this)();
+      }
+    }
+    m_state = state;
+  }
+
+  state_type m_state;
+};
+
+namespace priv {
+
+/**
+ * @brief Draw 64 uniform random bits (one draw of a 64-bit generator, two of a 32-bit one).
+ *
+ * @tparam RNG The type for the random number generator object.
+ * @param rng The random number generator object.
+ * @return std::uint64_t The random bits.
+ */
+template <typename RNG>
+std::uint64_t random_bits(RNG &rng) {
+  using result_type = typename RNG::result_type;
+  if constexpr (RNG::min() == 0 && RNG::max() == std::numeric_limits<std::uint64_t>::max()) {
+    return static_cast<std::uint64_t>(rng());
+  } else if constexpr (RNG::min() == 0 &&
+                       RNG::max() == std::numeric_limits<std::uint32_t>::max()) {
+    auto const high = static_cast<std::uint64_t>(rng());
+    return high << 32 | static_cast<std::uint64_t>(rng());
+  } else {
+    static_assert(std::is_unsigned_v<result_type>);
+    return std::uniform_int_distribution<std::uint64_t>()(rng);
+  }
+}
+}  // namespace priv
+}  // namespace apmnkl
+#endif  // RANDOM_HPP
@@ -0,0 +1,324 @@
+/**
+ * @file sink.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Destinations (sinks) of the anytime data rows pushed by the search heuristics.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef SINK_HPP
+#define SINK_HPP
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace apmnkl {
+
+/**
+ * @brief Destination of the anytime data of a run. The rows are pushed (in order) while
+ *        the algorithm runs, and the sink is flushed at the end of the run.
+ *
+ * @tparam Row The type for the rows, a tuple of <evaluation, keys..., hypervolume>.
+ */
+template <typename Row>
+class anytime_sink {
+ public:
+  using row_type = Row;
+
+  virtual ~anytime_sink() = default;
+
+  /// Receive the next row of anytime data
+  virtual void push(row_type const &row) = 0;
+
+  /// Write out the rows still buffered by the sink
+  virtual void flush() {}
+};
+
+/**
+ * @brief Sink keeping the rows in memory (the default sink of the algorithms).
+ *
+ * @tparam Row The type for the rows.
+ */
+template <typename Row>
+class memory_sink : public anytime_sink<Row> {
+ public:
+  void push(Row const &row) override {
+    m_rows.push_back(row);
+  }
+
+  /// Get the rows received so far
+  [[nodiscard]] auto const &rows() const {
+    return m_rows;
+  }
+
+  /// Discard the rows received so far
+  void clear() {
+    m_rows.clear();
+  }
+
+ private:
+  std::vector<Row> m_rows;
+};
+
+namespace priv {
+
+/// Fixed size buffer in front of an output stream, written out when full or flushed
+class output_buffer {
+ public:
+  explicit output_buffer(std::ostream &os, std::size_t const capacity = std::size_t(1) << 16)
+      : m_os(os)
+      , m_buffer(capacity) {}
+
+  output_buffer(output_buffer const &) = delete;
+  output_buffer &operator=(output_buffer const &) = delete;
+
+  ~output_buffer() {
+    flush();
+  }
+
+  /// Get room for (at most) n characters, to be followed by a commit of the characters used
+  [[nodiscard]] char *reserve(std::size_t const n) {
+    if (m_size + n > m_buffer.size()) {
+      flush();
+      if (n > m_buffer.size()) {
+        m_buffer.resize(n);
+      }
+    }
+    return m_buffer.data() + m_size;
+  }
+
+  /// Keep the characters written into the room reserved, up to (but excluding) last
+  void commit(char const *last) {
+    m_size = static_cast<std::size_t>(last - m_buffer.data());
+  }
+
+  /// Append a block of bytes to the buffer
+  void write(void const *data, std::size_t const n) {
+    auto *first = reserve(n);
+    std::memcpy(first, data, n);
+    commit(first + n);
+  }
+
+  /// Write the buffered characters to the stream (and flush the stream)
+  void flush() {
+    m_os.write(m_buffer.data(), static_cast<std::streamsize>(m_size));
+    m_os.flush();
+    m_size = 0;
+  }
+
+ private:
+  std::ostream &m_os;
+  std::vector<char> m_buffer;
+  std::size_t m_size = 0;
+};
+}  // namespace priv
+
+/**
+ * @brief Streaming csv sink (delimiter=","). The rows are formatted with std::to_chars into
+ *        a buffer written out to the stream whenever it fills up, so the memory used does not
+ *        grow with the run and a run that is killed only loses the rows of the last buffer.
+ *        The hypervolume values are written with 12 significant digits.
+ *
+ * @tparam Row The type for the rows.
+ */
+template <typename Row>
+class csv_sink : public anytime_sink<Row> {
+ public:
+  /**
+   * @brief Construct a new csv sink
+   *
+   * @param os The output stream where the csv should be written to.
+   * @param header The header row (names of the columns) of the csv.
+   * @param write_header Write the header row (e.g. false for the runs appended to a csv).
+   * @param seed The seed of the run, prefixed to every row (and "seed" to the header) if given.
+   */
+  csv_sink(std::ostream &os, std::string const &header, bool const write_header = true,
+           std::optional<unsigned int> const seed = std::nullopt)
+      : m_buffer(os)
+      , m_seed(seed) {
+    if (write_header) {
+      auto const line = (m_seed ? "seed," : "") + header + '\n';
+      m_buffer.write(line.data(), line.size());
+    }
+  }
+
+  void push(Row const &row) override {
+    auto *first = m_buffer.reserve(max_row_size);
+    auto *const last = first + max_row_size;
+    if (m_seed) {
+      first = m_field(first, last, *m_seed);
+      *first++ = ',';
+    }
+    std::apply(
+        [&first, last](auto const &...values) {
+          std::size_t column = 0;
+          ((first = m_field(first, last, values),
+            *first++ = ++column == sizeof...(values) ? '\n' : ','),
+           ...);
+        },
+        row);
+    m_buffer.commit(first);
+  }
+
+  void flush() override {
+    m_buffer.flush();
+  }
+
+ private:
+  // every field (and its delimiter) fits in 32 characters
+  static constexpr std::size_t max_field_size = 32;
+  static constexpr std::size_t max_row_size = (std::tuple_size_v<Row> + 1) * max_field_size;
+
+  template <typename V>
+  static char *m_field(char *first, char *last, V const value) {
+    if constexpr (std::is_floating_point_v<V>) {
+      return std::to_chars(first, last, value, std::chars_format::general, 12).ptr;
+    } else {
+      return std::to_chars(first, last, value).ptr;
+    }
+  }
+
+  priv::output_buffer m_buffer;
+  std::optional<unsigned int> m_seed;
+};
+
+/**
+ * @brief Streaming binary sink. The trace starts with a header:
+ *          - the magic "APMNKLAT" (8 bytes)
+ *          - the version of the format (uint32, 1)
+ *          - the number of columns (uint32)
+ *          - the type of each column (1 byte each, 'u' for uint64 and 'f' for float64)
+ *          - the length (uint32) and characters of the names of the columns (comma separated)
+ *        followed by the rows, every column taking 8 bytes. Everything is written in the
+ *        native byte order (the version tells it apart).
+ *
+ * @tparam Row The type for the rows.
+ */
+template <typename Row>
+class binary_sink : public anytime_sink<Row> {
+ public:
+  static constexpr char magic[8] = {'A', 'P', 'M', 'N', 'K', 'L', 'A', 'T'};
+  static constexpr std::uint32_t version = 1;
+
+  /**
+   * @brief Construct a new binary sink
+   *
+   * @param os The output stream where the trace should be written to (in binary mode).
+   * @param header The names of the columns (comma separated).
+   * @param write_header Write the header (e.g. false for the runs appended to a trace).
+   * @param seed The seed of the run, prefixed to every row (and "seed" to the header) if given.
+   */
+  binary_sink(std::ostream &os, std::string const &header, bool const write_header = true,
+              std::optional<unsigned int> const seed = std::nullopt)
+      : m_buffer(os)
+      , m_seed(seed) {
+    if (write_header) {
+      auto const names = (m_seed ? "seed," : "") + header;
+      auto const types = (m_seed ? std::string(1, 'u') : std::string()) + column_types();
+      auto const columns = static_cast<std::uint32_t>(types.size());
+      auto const length = static_cast<std::uint32_t>(names.size());
+      m_buffer.write(magic, sizeof(magic));
+      m_buffer.write(&version, sizeof(version));
+      m_buffer.write(&columns, sizeof(columns));
+      m_buffer.write(types.data(), types.size());
+      m_buffer.write(&length, sizeof(length));
+      m_buffer.write(names.data(), names.size());
+    }
+  }
+
+  void push(Row const &row) override {
+    if (m_seed) {
+      m_field(*m_seed);
+    }
+    std::apply([this](auto const &...values) { (m_field(values), ...); }, row);
+  }
+
+  void flush() override {
+    m_buffer.flush();
+  }
+
+  /// Get the types of the columns of the rows ('u' for uint64 and 'f' for float64)
+  [[nodiscard]] static std::string column_types() {
+    return std::apply([](auto const &...values) { return std::string{m_type(values)...}; },
+                      Row());
+  }
+
+ private:
+  template <typename V>
+  static constexpr char m_type(V const &) {
+    static_assert(std::is_arithmetic_v<V>, "the columns of a row must be arithmetic");
+    return std::is_floating_point_v<V> ? 'f' : 'u';
+  }
+
+  template <typename V>
+  void m_field(V const value) {
+    if constexpr (std::is_floating_point_v<V>) {
+      auto const field = static_cast<double>(value);
+      m_buffer.write(&field, sizeof(field));
+    } else {
+      auto const field = static_cast<std::uint64_t>(value);
+      m_buffer.write(&field, sizeof(field));
+    }
+  }
+
+  priv::output_buffer m_buffer;
+  std::optional<unsigned int> m_seed;
+};
+
+/**
+ * @brief Read the rows of a binary trace (written by a binary sink).
+ *
+ * @tparam Row The type for the rows (including the seed column, if the trace has one).
+ * @param is The input stream (in binary mode) holding the trace.
+ * @return std::vector<Row> The rows of the trace.
+ */
+template <typename Row>
+std::vector<Row> read_binary_trace(std::istream &is) {
+  char magic[sizeof(binary_sink<Row>::magic)];
+  std::uint32_t version = 0;
+  std::uint32_t columns = 0;
+  is.read(magic, sizeof(magic));
+  is.read(reinterpret_cast<char *>(&version), sizeof(version));
+  is.read(reinterpret_cast<char *>(&columns), sizeof(columns));
+  if (!is || std::memcmp(magic, binary_sink<Row>::magic, sizeof(magic)) != 0 ||
+      version != binary_sink<Row>::version) {
+    throw std::runtime_error("not a binary anytime trace (or unsupported version)");
+  }
+
+  std::string types(columns, '\0');
+  std::uint32_t length = 0;
+  is.read(types.data(), static_cast<std::streamsize>(types.size()));
+  is.read(reinterpret_cast<char *>(&length), sizeof(length));
+  is.ignore(length);
+  if (!is || types != binary_sink<Row>::column_types()) {
+    throw std::runtime_error("the columns of the binary anytime trace do not match the rows");
+  }
+
+  std::vector<Row> rows;
+  auto read_field = [&is](auto &value) {
+    using V = std::remove_reference_t<decltype(value)>;
+    using F = std::conditional_t<std::is_floating_point_v<V>, double, std::uint64_t>;
+    F field;
+    is.read(reinterpret_cast<char *>(&field), sizeof(field));
+    value = static_cast<V>(field);
+  };
+  for (Row row; std::apply([&](auto &...values) { (read_field(values), ...); }, row), is;) {
+    rows.push_back(row);
+  }
+  return rows;
+}
+}  // namespace apmnkl
+#endif  // SINK_HPP
@@ -13,13 +13,20 @@
 #define SOLUTION_HPP
 
 #include <cassert>
+#include <cstdint>
 #include <random>
+#include <utility>
+#include <vector>
 
+#include "bitset.hpp"
+#include "cache.hpp"
+#include "checkpoint.hpp"
+#include "profile.hpp"
 #include "rMNKEval.hpp"
 
 namespace apmnkl {
 
-using decision_vector = std::vector<bool>;
+using decision_vector = priv::packed_bitset;
 using objective_vector = std::vector<double>;
 
 namespace priv {
@@ -74,7 +81,7 @@ class solution {
    * @param rmnk A lvalue reference to the RMNK instance evaluator.
    * @param decision The solution's decision vector.
    */
-  solution(RMNKEval &rmnk, decision_vector const &decision)
+  solution(RMNKEval const &rmnk, decision_vector const &decision)
       : m_decision(decision) {
     eval(rmnk);
   }
@@ -85,11 +92,75 @@ class solution {
    * @param rmnk A lvalue reference to the RMNK instance evaluator.
    * @param decision The solution's decision vector.
    */
-  solution(RMNKEval &rmnk, decision_vector &&decision)
+  solution(RMNKEval const &rmnk, decision_vector &&decision)
       : m_decision(std::move(decision)) {
     eval(rmnk);
   }
 
+  /**
+   * @brief Construct a new solution object that differs from another one
+   *        by a single bit (incremental evaluation).
+   *
+   * @param rmnk A lvalue reference to the RMNK instance evaluator.
+   * @param parent The solution from which the new one is derived.
+   * @param bit The index of the bit to be flipped.
+   */
+  solution(RMNKEval const &rmnk, solution const &parent, std::size_t const bit)
+      : m_decision(parent.m_decision)
+      , m_objective(parent.m_objective) {
+    flip(rmnk, bit);
+  }
+
+  /**
+   * @brief Construct a new solution object that differs from another one
+   *        by a set of bits (incremental evaluation).
+   *
+   * @param rmnk A lvalue reference to the RMNK instance evaluator.
+   * @param parent The solution from which the new one is derived.
+   * @param bits The indexes of the bits to be flipped.
+   */
+  solution(RMNKEval const &rmnk, solution const &parent, std::vector<unsigned> const &bits)
+      : m_decision(parent.m_decision)
+      , m_objective(parent.m_objective) {
+    rmnk.evalFlips(m_decision, m_objective, bits);
+  }
+
+  /**
+   * @brief Construct a new solution object from a neighbor of another one
+   *        already evaluated in a batch (no evaluation is performed).
+   *
+   * @param parent The solution from which the new one is derived.
+   * @param bit The index of the bit flipped by the neighbor.
+   * @param batch The batch holding the objective vector of the neighbor.
+   * @param index The index of the neighbor in the batch.
+   */
+  solution(solution const &parent, std::size_t const bit, NeighborBatch const &batch,
+           std::size_t const index)
+      : m_decision(parent.m_decision)
+      , m_objective(parent.m_objective.size()) {
+    m_decision.flip(bit);
+    for (std::size_t n = 0; n < m_objective.size(); ++n) {
+      m_objective[n] = batch.objective(static_cast<unsigned>(n), index);
+    }
+  }
+
+  /**
+   * @brief Construct a new solution object from a neighbor of another one reached by a one-
+   *        or two-bit move and already evaluated in a batch (no evaluation is performed).
+   *
+   * @param parent The solution from which the new one is derived.
+   * @param move The bits flipped by the neighbor.
+   * @param batch The batch holding the objective vector of the neighbor.
+   * @param index The index of the neighbor in the batch.
+   */
+  solution(solution const &parent, NeighborMove const &move, NeighborBatch const &batch,
+           std::size_t const index)
+      : solution(parent, move.first, batch, index) {
+    if (move.second != move.first) {
+      m_decision.flip(move.second);
+    }
+  }
+
   /**
    * @brief Getter for the solution's decision vector.
    *
@@ -100,6 +171,16 @@ class solution {
     return m_decision;
   }
 
+  /**
+   * @brief Getter for the solution's decision vector. The solution has to be
+   *        re-evaluated after its decision vector is modified.
+   *
+   * @return decv_type& A reference to the solution's decision vector.
+   */
+  decv_type &decision_vector() {
+    return m_decision;
+  }
+
   /**
    * @brief Getter for the solution's objective vector.
    *
@@ -128,6 +209,7 @@ class solution {
    */
   dominance_type dominance(solution const &s) const {
     assert(m_decision.size() == s.m_decision.size());
+    APMNKL_PROFILE_COUNT(comparisons, 1);
 
     auto res = dominance_type::equal;
     for (decltype(m_objective.size()) i = 0; i < m_objective.size(); ++i) {
@@ -168,10 +250,9 @@ class solution {
    *        decision vector implementation.
    *
    * @param i The index of the element to be accessed.
-   * @return decv_type::reference A lvalue reference to value contained in the
-   *                              accessed index.
+   * @return bool The value contained in the accessed index.
    */
-  decv_type::reference operator[](std::size_t const i) {
+  bool operator[](std::size_t const i) const {
     return m_decision[i];
   }
 
@@ -183,10 +264,44 @@ class solution {
    * @param rmnk The RMNK instance evaluator instance that provides the method used
    *             for solution evaluation.
    */
-  void eval(RMNKEval &rmnk) {
+  void eval(RMNKEval const &rmnk) {
     rmnk.eval(m_decision, m_objective);
   }
 
+  /**
+   * @brief Flip the i-th bit of the solution's decision vector and
+   *        update its objective vector incrementally.
+   *
+   * @param rmnk The RMNK instance evaluator instance that provides the method used
+   *             for solution evaluation.
+   * @param i The index of the bit to be flipped.
+   */
+  void flip(RMNKEval const &rmnk, std::size_t const i) {
+    rmnk.evalFlip(m_decision, m_objective, static_cast<unsigned>(i));
+  }
+
+  /**
+   * @brief Save the solution (its decision and objective vectors) into a checkpoint.
+   *
+   * @param writer The checkpoint writer.
+   */
+  void save(checkpoint_writer &writer) const {
+    writer.write_size(m_decision.size());
+    writer.write_block(m_decision.data(), m_decision.word_count());
+    writer.write(m_objective);
+  }
+
+  /**
+   * @brief Load the solution from a checkpoint (no evaluation is performed).
+   *
+   * @param reader The checkpoint reader.
+   */
+  void load(checkpoint_reader &reader) {
+    m_decision = decv_type(reader.read_length());
+    reader.read_block(m_decision.data(), m_decision.word_count());
+    reader.read(m_objective);
+  }
+
   /**
    * @brief Build and evaluate a new random solution object.
    *
@@ -196,12 +311,12 @@ class solution {
    * @return solution A new Solution object containing a random solution.
    */
   template <typename RNG>
-  static solution random_solution(RMNKEval &eval, RNG &generator) {
+  static solution random_solution(RMNKEval const &eval, RNG &generator) {
     std::uniform_int_distribution<int> distrib(0, 1);
 
-    decv_type decision_vector(eval.getN(), 0);
+    decv_type decision_vector(eval.getN());
     for (std::size_t i = 0; i < decision_vector.size(); ++i)
-      decision_vector[i] = distrib(generator);
+      decision_vector.set(i, distrib(generator));
 
     return solution(eval, std::move(decision_vector));
   }
@@ -219,52 +334,200 @@ class solution {
    * @return solution A new olution object containing a random solution.
    */
   template <typename RNG>
-  static solution uniform_bit_flip_solution(RMNKEval &eval, RNG &generator,
+  static solution uniform_bit_flip_solution(RMNKEval const &eval, RNG &generator,
                                             solution const &original) {
-    std::bernoulli_distribution distrib(1 / static_cast<double>(original.decision_vector().size()));
+    std::vector<unsigned> flipped;
+    uniform_bit_flips(original.size(), generator, flipped);
+    return solution(eval, original, flipped);
+  }
 
-    decv_type flipped = original.decision_vector();
-    for (decltype(flipped.size()) i = 0; i < flipped.size(); ++i) {
-      if (distrib(generator)) {
-        flipped[i] = !flipped[i];
-      }
+  /**
+   * @brief Sample the bits flipped by a uniform mutation, i.e. every bit is flipped with
+   *        probability 1/n. The gaps between flipped bits are geometrically distributed,
+   *        so they are sampled directly and the cost is O(expected flips) rather than O(n).
+   *
+   * @tparam RNG The type for the random number generator object.
+   * @param n The size of the decision vector.
+   * @param generator The random number generator object
+   * @param flipped The indexes of the bits to be flipped (in increasing order).
+   */
+  template <typename RNG>
+  static void uniform_bit_flips(std::size_t const n, RNG &generator,
+                                std::vector<unsigned> &flipped) {
+    flipped.clear();
+    std::geometric_distribution<std::size_t> gap(1 / static_cast<double>(n));
+    for (std::size_t i = gap(generator); i < n; i += 1 + gap(generator)) {
+      flipped.push_back(static_cast<unsigned>(i));
     }
-    return solution(eval, std::move(flipped));
   }
 
   /**
-   * @brief Calculate all the neighboor solutions of the current one.
+   * @brief Make this solution a copy of another one with a set of bits flipped
+   *        (incremental evaluation), reusing the storage of this solution.
    *
    * @param eval  The instance evaluator object.
-   * @param generator The random number generator object
+   * @param original The solution from which this one is derived.
+   * @param flipped The indexes of the bits to be flipped.
+   */
+  void assign_flipped(RMNKEval const &eval, solution const &original,
+                      std::vector<unsigned> const &flipped) {
+    m_decision = original.m_decision;
+    m_objective = original.m_objective;
+    if (!flipped.empty()) {
+      eval.evalFlips(m_decision, m_objective, flipped);
+    }
+  }
+
+  /**
+   * @brief Make this solution a copy of another one with a set of bits flipped, looked up in
+   *        an evaluation cache: it is only evaluated (incrementally) if the cache does not
+   *        hold it, and then inserted into the cache.
+   *
+   * @param eval  The instance evaluator object.
+   * @param original The solution from which this one is derived.
+   * @param flipped The indexes of the bits to be flipped.
+   * @param cache The evaluation cache.
+   * @return true If the cache held the solution (no evaluation was performed).
+   */
+  bool assign_flipped(RMNKEval const &eval, solution const &original,
+                      std::vector<unsigned> const &flipped, evaluation_cache &cache) {
+    m_decision = original.m_decision;
+    for (auto const bit : flipped) {
+      m_decision.flip(bit);
+    }
+    if (cache.find(m_decision, m_objective)) {
+      return true;
+    }
+    assign_flipped(eval, original, flipped);
+    cache.insert(m_decision, m_objective);
+    return false;
+  }
+
+  /**
+   * @brief Calculate all the neighboor solutions of the current one, i.e. the ones flipping
+   *        one bit followed by the ones swapping two different bits (both evaluated
+   *        incrementally, in a batch).
+   *
+   * @param eval  The instance evaluator object.
+   * @param original The solution whose neighborhood is calculated.
    * @return std::vector<solution> A vector of solutions containing the current
    *                               solution neighboor solutions.
    *
    */
-  static std::vector<solution> neighborhood_solutions(RMNKEval &eval, solution const &original) {
+  static std::vector<solution> neighborhood_solutions(RMNKEval const &eval,
+                                                      solution const &original) {
+    auto const &decision = original.decision_vector();
+    std::vector<NeighborMove> moves;
+    moves.reserve(decision.size());
+    for (size_t i = 0; i < decision.size(); ++i) {
+      moves.push_back({static_cast<unsigned>(i), static_cast<unsigned>(i)});
+    }
+    for (size_t i = 0; i < decision.size(); ++i) {
+      for (size_t j = i + 1; j < decision.size(); ++j) {
+        if (decision[i] != decision[j]) {
+          moves.push_back({static_cast<unsigned>(i), static_cast<unsigned>(j)});
+        }
+      }
+    }
+
+    NeighborBatch batch;
+    eval.evalMoves(decision, original.objective_vector(), moves, batch);
     std::vector<solution> neighborhood;
-    neighborhood.reserve(original.decision_vector().size());
+    neighborhood.reserve(moves.size());
+    for (size_t b = 0; b < moves.size(); ++b) {
+      neighborhood.emplace_back(original, moves[b], batch, b);
+    }
+    return neighborhood;
+  }
+};
 
-    for (size_t i = 0; i < original.decision_vector().size(); ++i) {
-      auto decv = original.decision_vector();
-      decv[i] = !decv[i];
+/**
+ * @brief Moves to the neighbors of a solution (flipping one bit, swapping two different bits,
+ *        or both) drawn lazily in a uniformly random order, i.e. a Fisher-Yates shuffle of
+ *        the moves driven one draw at a time, so an exploration that stops at its first
+ *        accepted neighbor draws (and evaluates) only a few moves of an O(N^2) neighborhood.
+ *        The swaps are drawn from every pair of bits, the ones of two equal bits (no
+ *        neighbor) being skipped. The moves shuffled are restored once an exploration
+ *        restarts, so the order only depends on the generator. The flip neighborhood alone is
+ *        scanned in the order of the bits (without drawing from the generator).
+ */
+class neighborhood_sampler {
+ public:
+  neighborhood_sampler() = default;
 
-      neighborhood.emplace_back(eval, std::move(decv));
+  /**
+   * @brief Construct a new neighborhood_sampler object.
+   *
+   * @param n The number of bits of the solutions.
+   * @param flips Include the moves flipping one bit.
+   * @param swaps Include the moves swapping two different bits.
+   */
+  neighborhood_sampler(std::size_t const n, bool const flips, bool const swaps)
+      : m_ordered(!swaps) {
+    m_moves.reserve((flips ? n : 0) + (swaps ? n * (n - 1) / 2 : 0));
+    for (std::size_t i = 0; flips && i < n; ++i) {
+      m_moves.push_back({static_cast<unsigned>(i), static_cast<unsigned>(i)});
+    }
+    for (std::size_t i = 0; swaps && i < n; ++i) {
+      for (std::size_t j = i + 1; j < n; ++j) {
+        m_moves.push_back({static_cast<unsigned>(i), static_cast<unsigned>(j)});
+      }
+    }
+    m_order.resize(m_moves.size());
+    for (std::size_t k = 0; k < m_order.size(); ++k) {
+      m_order[k] = static_cast<std::uint32_t>(k);
     }
+  }
 
-    for (size_t i = 0; i < original.decision_vector().size(); ++i) {
-      for (size_t j = i + 1; j < original.decision_vector().size(); ++j) {
-        if (original.decision_vector()[i] == original.decision_vector()[j]) {
-          continue;
-        }
+  /// Check if every move was drawn since the exploration restarted
+  [[nodiscard]] bool exhausted() const noexcept {
+    return m_next == m_moves.size();
+  }
 
-        auto decv = original.decision_vector();
-        swap(decv[i], decv[j]);
-        neighborhood.emplace_back(eval, std::move(decv));
+  /// Restart the exploration of a (new) neighborhood
+  void restart() noexcept {
+    for (auto const k : m_touched) {
+      m_order[k] = static_cast<std::uint32_t>(k);
+    }
+    m_touched.clear();
+    m_next = 0;
+  }
+
+  /**
+   * @brief Draw the next moves to the neighbors of a solution.
+   *
+   * @tparam RNG The type for the random number generator object.
+   * @param decision The decision vector of the solution.
+   * @param generator The random number generator object.
+   * @param count The number of moves drawn (fewer once the neighborhood is exhausted).
+   * @param moves The moves drawn.
+   */
+  template <typename RNG>
+  void draw(decision_vector const &decision, RNG &generator, std::size_t const count,
+            std::vector<NeighborMove> &moves) {
+    moves.clear();
+    while (moves.size() < count && m_next < m_moves.size()) {
+      if (!m_ordered) {
+        std::uniform_int_distribution<std::size_t> distrib(m_next, m_moves.size() - 1);
+        auto const k = distrib(generator);
+        std::swap(m_order[m_next], m_order[k]);
+        m_touched.push_back(m_next);
+        m_touched.push_back(k);
+      }
+      auto const &move = m_moves[m_order[m_next++]];
+      if (move.first == move.second || decision[move.first] != decision[move.second]) {
+        moves.push_back(move);
       }
     }
-    return neighborhood;
   }
+
+ private:
+  bool m_ordered = true;
+  std::vector<NeighborMove> m_moves;
+  // the moves in the order drawn (the first m_next ones), and the positions shuffled
+  std::vector<std::uint32_t> m_order;
+  std::vector<std::size_t> m_touched;
+  std::size_t m_next = 0;
 };
 
 /// Genetic algorithm solution wrapper (adds a fitness attribute to the Solution class)
@@ -326,6 +589,26 @@ class gasolution : public solution {
   constexpr void set_fitness(double const fitness) {
     m_fitness = fitness;
   }
+
+  /**
+   * @brief Save the solution (and its fitness value) into a checkpoint.
+   *
+   * @param writer The checkpoint writer.
+   */
+  void save(checkpoint_writer &writer) const {
+    solution::save(writer);
+    writer.write(m_fitness);
+  }
+
+  /**
+   * @brief Load the solution (and its fitness value) from a checkpoint.
+   *
+   * @param reader The checkpoint reader.
+   */
+  void load(checkpoint_reader &reader) {
+    solution::load(reader);
+    reader.read(m_fitness);
+  }
 };
 }  // namespace priv
 }  // namespace apmnkl
@@ -0,0 +1,159 @@
+/**
+ * @file thread_pool.hpp
+ * @author Pedro Rodrigues (pedror@student.dei.uc.pt)
+ * @author Alexandre Jesus (ajesus@dei.uc.pt)
+ * @brief Fixed-size pool of worker threads executing tasks from a shared queue.
+ * @version 0.2.0
+ * @date 14-10-2026
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace apmnkl {
+
+namespace priv {
+
+/// Fixed-size pool of worker threads executing (in FIFO order) the tasks submitted to it
+class thread_pool {
+ public:
+  /**
+   * @brief Construct a new thread pool object
+   *
+   * @param threads The number of worker threads (0 to use one per hardware thread).
+   */
+  explicit thread_pool(std::size_t threads = 0) {
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+      m_workers.emplace_back([this]() { m_work(); });
+    }
+  }
+
+  thread_pool(thread_pool const &other) = delete;
+  thread_pool &operator=(thread_pool const &other) = delete;
+
+  /// Wait for the tasks already submitted and join the worker threads
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_ready.notify_all();
+    for (auto &worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  /// Get the number of worker threads
+  [[nodiscard]] auto size() const {
+    return m_workers.size();
+  }
+
+  /**
+   * @brief Submit a task to the pool.
+   *
+   * @tparam F The type for the task (callable with no arguments).
+   * @param task The task to be executed by one of the workers.
+   * @return std::future The future holding the result (or the exception) of the task.
+   */
+  template <typename F>
+  auto submit(F &&task) {
+    using result_type = std::invoke_result_t<std::decay_t<F>>;
+    auto packaged = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(task));
+    auto result = packaged->get_future();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.emplace([packaged]() { (*packaged)(); });
+    }
+    m_ready.notify_one();
+    return result;
+  }
+
+  /**
+   * @brief Execute a task over the range [0, size), split into contiguous blocks run by the
+   *        workers and by the calling thread, and wait for every block to complete.
+   *
+   * If a block throws, the first exception (that of the calling thread, or else that of the
+   * first block) is rethrown once every block submitted has completed, as they refer to the task.
+   *
+   * @tparam F The type for the task (callable with the bounds [first, last) of a block).
+   * @param size The size of the range.
+   * @param task The task to be executed on every block of the range.
+   */
+  template <typename F>
+  void parallel_for(std::size_t const size, F &&task) {
+    auto const blocks = std::min(size, m_workers.size() + 1);
+    if (blocks <= 1) {
+      task(std::size_t(0), size);
+      return;
+    }
+
+    std::vector<std::future<void>> pending;
+    pending.reserve(blocks - 1);
+    // waits for the blocks not collected yet when leaving early (on an exception)
+    struct wait_pending {
+      std::vector<std::future<void>> &pending;
+      ~wait_pending() {
+        for (auto &block : pending) {
+          if (block.valid()) {
+            block.wait();
+          }
+        }
+      }
+    } const guard{pending};
+    for (std::size_t b = 1; b < blocks; ++b) {
+      pending.push_back(submit([&task, size, blocks, b]() {
+        task(b * size / blocks, (b + 1) * size / blocks);
+      }));
+    }
+    task(std::size_t(0), size / blocks);
+    for (auto &block : pending) {
+      block.get();
+    }
+  }
+
+ private:
+  void m_work() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_ready.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+        if (m_tasks.empty()) {
+          return;
+        }
+        task = std::move(m_tasks.front());
+        m_tasks.pop();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> m_workers;
+  std::queue<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_ready;
+  bool m_stop = false;
+};
+}  // namespace priv
+}  // namespace apmnkl
+#endif  // THREAD_POOL_HPP
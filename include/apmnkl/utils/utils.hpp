@@ -13,6 +13,7 @@
 #ifndef UTILS_HPP
 #define UTILS_HPP
 
+#include "archive.hpp"
 #include "solution.hpp"
 
 namespace apmnkl {
@@ -33,6 +34,7 @@ namespace priv {
  */
 template <typename Vec, typename S>
 bool add_non_dominated(Vec &solutions, S &&solution) {
+  APMNKL_PROFILE_SCOPE(archive);
   for (std::size_t i = 0; i < solutions.size();) {
     auto d = solution.dominance(solutions[i]);
     if (d == dominance_type::equal) {
@@ -56,8 +58,110 @@ bool add_non_dominated(Vec &solutions, S &&solution) {
     }
   }
   solutions.push_back(std::forward<S>(solution));
+  APMNKL_PROFILE_MAX(archive_size, solutions.size());
   return true;
 }
+
+/**
+ * @brief Utility function resposible for maintaining an (indexed)
+ *        archive of non-dominated solutions
+ *
+ * @tparam A The type for the solutions of the archive.
+ * @tparam S The type for a solution to be added to the archive.
+ * @param solutions The archive of non-dominated solutions.
+ * @param solution The solution to be added to the archive.
+ * @return true If the solution was successfully added to the archive
+ * @return false If the solution to be added is dominated by other solution already
+ *               present and failed to be inserted.
+ */
+template <typename A, typename S>
+bool add_non_dominated(archive<A> &solutions, S &&solution) {
+  APMNKL_PROFILE_SCOPE(archive);
+  auto const inserted = solutions.insert(std::forward<S>(solution));
+  APMNKL_PROFILE_MAX(archive_size, solutions.size());
+  return inserted;
+}
+
+/// Objective vector of a neighbor evaluated in a batch (indexable by objective)
+struct neighbor_point {
+  NeighborBatch const &batch;
+  std::size_t index;
+
+  double operator[](std::size_t const n) const {
+    return batch.objective(static_cast<unsigned>(n), index);
+  }
+};
+
+/**
+ * @brief Calculate the objective dominance type of a neighbor evaluated in a
+ *        batch with respect to a solution (same semantics as solution::dominance).
+ *
+ * @param batch The batch holding the objective vector of the neighbor.
+ * @param index The index of the neighbor in the batch.
+ * @param s A solution whose dominance type of the neighbor will be tested against.
+ * @return dominance_type The neighbor's dominance type
+ */
+inline dominance_type dominance(NeighborBatch const &batch, std::size_t const index,
+                                solution const &s) {
+  APMNKL_PROFILE_COUNT(comparisons, 1);
+  auto const &objv = s.objective_vector();
+
+  auto res = dominance_type::equal;
+  for (std::size_t n = 0; n < objv.size(); ++n) {
+    double const value = batch.objective(static_cast<unsigned>(n), index);
+    if (value < objv[n]) {
+      if (res == dominance_type::dominates) {
+        return dominance_type::incomparable;
+      }
+      res = dominance_type::dominated;
+    } else if (value > objv[n]) {
+      if (res == dominance_type::dominated) {
+        return dominance_type::incomparable;
+      }
+      res = dominance_type::dominates;
+    }
+  }
+  return res;
+}
+
+/**
+ * @brief Utility function checking if a neighbor evaluated in a batch is
+ *        dominated by a solution of a container of non-dominated solutions,
+ *        i.e. if add_non_dominated would reject it regardless of its decision vector.
+ *
+ * @tparam Vec The type for the container holding the solutions.
+ * @param solutions The container for the non-dominated solutions.
+ * @param batch The batch holding the objective vector of the neighbor.
+ * @param index The index of the neighbor in the batch.
+ * @return true If a solution of the container dominates the neighbor.
+ */
+template <typename Vec>
+bool is_dominated(Vec const &solutions, NeighborBatch const &batch, std::size_t const index) {
+  APMNKL_PROFILE_SCOPE(archive);
+  for (auto const &s : solutions) {
+    if (dominance(batch, index, s) == dominance_type::dominated) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Utility function checking if a neighbor evaluated in a batch is
+ *        dominated by a solution of an (indexed) archive.
+ *
+ * @tparam A The type for the solutions of the archive.
+ * @param solutions The archive of non-dominated solutions.
+ * @param batch The batch holding the objective vector of the neighbor.
+ * @param index The index of the neighbor in the batch.
+ * @return true If a solution of the archive dominates the neighbor.
+ */
+template <typename A>
+bool is_dominated(archive<A> const &solutions, NeighborBatch const &batch,
+                  std::size_t const index) {
+  APMNKL_PROFILE_SCOPE(archive);
+  return solutions.is_dominated(neighbor_point{batch, index});
+}
 }  // namespace priv
 }  // namespace apmnkl
 #endif  // UTILS_HPP
@@ -12,10 +12,20 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
+#include "checkpoint.hpp"
+#include "hvmc.hpp"
+#include "profile.hpp"
+
 // This code assumes maximizing objective functions
 
 namespace apmnkl {
@@ -110,6 +120,484 @@ auto point_hv(T const& p, R const& r) {
   return res;
 }
 
+/**
+ * @brief Compute the hypervolume difference of two points, i.e. the hypervolume dominated
+ *        by b and not by a, or hv(b) - hv(a) if a weakly dominates b. For two points this
+ *        has a closed form, hv(b) - hv(min(a, b)), so no set is built (no allocation) and,
+ *        for a fixed number of objectives, the loop is unrolled by the compiler.
+ *
+ * @tparam M The number of objectives (0 if only known at runtime).
+ * @tparam T The type for the objective values.
+ * @param a The first point.
+ * @param b The second point.
+ * @param r The reference point.
+ * @param m The number of objectives (if M is 0).
+ * @return T The hypervolume difference.
+ */
+template <std::size_t M, typename T>
+T pair_hv_difference(T const* a, T const* b, T const* r, std::size_t const m = M) {
+  auto const size = M != 0 ? M : m;
+  auto ha = a[0] - r[0];
+  auto hb = b[0] - r[0];
+  auto hm = std::min(a[0], b[0]) - r[0];
+  bool dominates = a[0] >= b[0];
+  for (std::size_t i = 1; i < size; ++i) {
+    ha *= a[i] - r[i];
+    hb *= b[i] - r[i];
+    hm *= std::min(a[i], b[i]) - r[i];
+    dominates &= a[i] >= b[i];
+  }
+  return dominates ? hb - ha : hb - hm;
+}
+
+/// Identity projection of the points of a set
+struct point_identity {
+  template <typename V>
+  constexpr V const& operator()(V const& v) const noexcept {
+    return v;
+  }
+};
+
+/**
+ * @brief WFG hypervolume engine over flat, preallocated workspaces. The sets of every depth
+ *        of the recursion live in one contiguous buffer of n x m values per depth, which
+ *        only grows (and is reused) across the calls, so once it fits the work load the
+ *        engine does not allocate. The set is sliced by decreasing values of its first
+ *        objective (down to the 3d sweep), and the usual heuristics are applied:
+ *          - the objectives of a contribution are reordered so that the objectives where
+ *            the fewest points are clamped by the contributing point are sliced first;
+ *          - the points are sorted by decreasing first objective once, and the fronts of the
+ *            slices are kept sorted (the limit is monotone), so a point can only be dominated
+ *            by the points preceding it or dominate the ones tied with it;
+ *          - a point weakly dominated by the set (of its slice) contributes nothing, a point
+ *            limiting no point contributes its own hypervolume, and the limited points with
+ *            an empty box (w.r.t. the reference point), or below the bounding points (the
+ *            ones clamped in every objective but one), are dropped beforehand.
+ *        The hypervolume is the one of maximized objectives w.r.t. the reference point.
+ *
+ * @tparam T The type for the objective values (and the hypervolume).
+ */
+template <typename T>
+class wfg {
+ public:
+  using hv_type = T;
+
+  /**
+   * @brief Construct a new wfg object
+   *
+   * @param m The number of objectives.
+   */
+  explicit wfg(std::size_t const m)
+      : m_m(m)
+      , m_levels(m) {}
+
+  /// The copy of the engine is a new engine (with empty workspaces), they are never shared
+  wfg(wfg const& other)
+      : wfg(other.m_m) {}
+
+  wfg(wfg&& other) noexcept = default;
+
+  wfg& operator=(wfg const& other) {
+    *this = wfg(other.m_m);
+    return *this;
+  }
+
+  wfg& operator=(wfg&& other) noexcept = default;
+
+  /**
+   * @brief Compute the hypervolume of a set of points.
+   *
+   * @tparam S The type for the set.
+   * @tparam R The type for the reference point.
+   * @tparam P The type for the projection of the elements of the set.
+   * @param s The set of points (not necessarily non dominated, nor sorted).
+   * @param r The reference point.
+   * @param proj The projection of an element of the set to its (random access) point.
+   * @return hv_type The hypervolume of the set.
+   */
+  template <typename S, typename R, typename P = point_identity>
+  [[nodiscard]] hv_type set_hv(S const& s, R const& r, P proj = {}) {
+    m_identity_order();
+    m_load_reference(r);
+    auto& level = m_levels[0];
+    m_reserve(level.points, s.size() * m_m);
+    std::size_t n = 0;
+    for (auto const& e : s) {
+      auto const& p = proj(e);
+      auto* row = level.points.data() + n * m_m;
+      for (std::size_t i = 0; i < m_m; ++i) {
+        row[i] = p[i];
+      }
+      n += m_has_volume(row, m_reference.data(), m_m);
+    }
+    return m_hv(0, m_sort_non_dominated(0, n, m_m), m_m, m_reference.data());
+  }
+
+  /**
+   * @brief Compute the hypervolume contribution of a point to a set of points, i.e. the
+   *        hypervolume dominated by the point and not by the set.
+   *
+   * @tparam V The type for the point.
+   * @tparam S The type for the set.
+   * @tparam R The type for the reference point.
+   * @tparam P The type for the projection of the elements of the set.
+   * @param v The contributing point.
+   * @param s The set of points (not necessarily non dominated, nor sorted).
+   * @param r The reference point.
+   * @param proj The projection of an element of the set to its (random access) point.
+   * @return hv_type The contribution of the point (exactly 0 if the set weakly dominates it).
+   */
+  template <typename V, typename S, typename R, typename P = point_identity>
+  [[nodiscard]] hv_type contribution(V const& v, S const& s, R const& r, P proj = {}) {
+    for (std::size_t i = 0; i < m_m; ++i) {
+      if (v[i] <= r[i]) {
+        return 0;
+      }
+    }
+
+    // objectives where more points are clamped to v are sliced last (fewer distinct values),
+    // and the points clamped in every objective but one bound the limited set: every point
+    // below the largest of them in that objective is dominated
+    m_clamped.assign(m_m, 0);
+    m_bound.assign(m_m, std::numeric_limits<hv_type>::lowest());
+    for (auto const& e : s) {
+      auto const& q = proj(e);
+      std::size_t clamped = 0;
+      std::size_t free = 0;
+      for (std::size_t i = 0; i < m_m; ++i) {
+        if (q[i] >= v[i]) {
+          ++m_clamped[i];
+          ++clamped;
+        } else {
+          free = i;
+        }
+      }
+      APMNKL_PROFILE_COUNT(comparisons, 1);
+      if (clamped == m_m) {
+        return 0;
+      } else if (clamped + 1 == m_m) {
+        m_bound[free] = std::max(m_bound[free], static_cast<hv_type>(q[free]));
+      }
+    }
+    m_order.resize(m_m);
+    std::iota(m_order.begin(), m_order.end(), std::size_t(0));
+    std::sort(m_order.begin(), m_order.end(), [this](auto const a, auto const b) {
+      return m_clamped[a] < m_clamped[b] || (m_clamped[a] == m_clamped[b] && a < b);
+    });
+    m_load_reference(r);
+    m_point.resize(m_m);
+    for (std::size_t i = 0; i < m_m; ++i) {
+      m_point[i] = v[m_order[i]];
+    }
+
+    // limited set, without the points with an empty box and the bounded ones
+    auto& level = m_levels[0];
+    m_reserve(level.points, s.size() * m_m);
+    std::size_t n = 0;
+    for (auto const& e : s) {
+      auto const& q = proj(e);
+      auto* row = level.points.data() + n * m_m;
+      bool bounded = false;
+      for (std::size_t i = 0; i < m_m; ++i) {
+        auto const x = static_cast<hv_type>(q[m_order[i]]);
+        bounded |= x < m_bound[m_order[i]];
+        row[i] = std::min(x, m_point[i]);
+      }
+      n += !bounded && m_has_volume(row, m_reference.data(), m_m);
+    }
+
+    auto const hv = m_point_hv(m_point.data(), m_reference.data(), m_m);
+    if (n == 0) {
+      return hv;
+    }
+    return hv - m_hv(0, m_sort_non_dominated(0, n, m_m), m_m, m_reference.data());
+  }
+
+ private:
+  /// Workspace of a depth of the recursion (the buffers only grow)
+  struct workspace {
+    // the set of the depth (n x m)
+    std::vector<hv_type> points;
+    // the projections of the points of the set sliced so far (n x (m - 1))
+    std::vector<hv_type> front;
+    // the sorted non dominated points (n x m), swapped with points once sorted
+    std::vector<hv_type> sorted;
+    std::vector<std::size_t> order;
+  };
+
+  /// Grow a workspace buffer (if needed) to a given size
+  template <typename B>
+  static void m_reserve(B& buffer, std::size_t const size) {
+    if (buffer.size() < size) {
+      APMNKL_PROFILE_COUNT(heap_allocations, 1);
+      buffer.resize(std::max(size, 2 * buffer.size()));
+    }
+  }
+
+  void m_identity_order() {
+    m_order.resize(m_m);
+    std::iota(m_order.begin(), m_order.end(), std::size_t(0));
+  }
+
+  /// Copy the reference point (in the order of the objectives)
+  template <typename R>
+  void m_load_reference(R const& r) {
+    m_reference.resize(m_m);
+    for (std::size_t i = 0; i < m_m; ++i) {
+      m_reference[i] = r[m_order[i]];
+    }
+  }
+
+  static bool m_has_volume(hv_type const* p, hv_type const* r, std::size_t const m) {
+    for (std::size_t i = 0; i < m; ++i) {
+      if (p[i] <= r[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool m_weakly_dominates(hv_type const* a, hv_type const* b, std::size_t const m) {
+    APMNKL_PROFILE_COUNT(comparisons, 1);
+    for (std::size_t i = 0; i < m; ++i) {
+      if (a[i] < b[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static hv_type m_point_hv(hv_type const* p, hv_type const* r, std::size_t const m) {
+    auto res = p[0] - r[0];
+    for (std::size_t i = 1; i < m; ++i) {
+      res *= p[i] - r[i];
+    }
+    return res;
+  }
+
+  /**
+   * @brief Drop the weakly dominated points of the set of a depth, and sort the remaining ones
+   *        by decreasing first objective.
+   *
+   * @param depth The depth of the set.
+   * @param n The number of points of the set.
+   * @param m The number of objectives of the set.
+   * @return std::size_t The number of non dominated points (sorted, in place of the set).
+   */
+  std::size_t m_sort_non_dominated(std::size_t const depth, std::size_t const n,
+                                   std::size_t const m) {
+    auto& level = m_levels[depth];
+    auto* points = level.points.data();
+
+    // the non dominated points are kept at the front of the set, the last point found to
+    // dominate a point being moved first (it is likely to dominate the next ones too)
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      auto const* p = points + i * m;
+      bool dominated = false;
+      for (std::size_t j = 0; j < size && !dominated;) {
+        auto* q = points + j * m;
+        if (m_weakly_dominates(q, p, m)) {
+          std::swap_ranges(q, q + m, points);
+          dominated = true;
+        } else if (m_weakly_dominates(p, q, m)) {
+          std::copy(points + (size - 1) * m, points + size * m, q);
+          --size;
+        } else {
+          ++j;
+        }
+      }
+      if (!dominated) {
+        std::copy(p, p + m, points + size++ * m);
+      }
+    }
+    if (size < 2) {
+      return size;
+    }
+
+    m_reserve(level.order, size);
+    auto* order = level.order.data();
+    std::iota(order, order + size, std::size_t(0));
+    std::sort(order, order + size,
+              [points, m](auto const a, auto const b) { return points[a * m] > points[b * m]; });
+    m_reserve(level.sorted, size * m);
+    for (std::size_t i = 0; i < size; ++i) {
+      std::copy(points + order[i] * m, points + (order[i] + 1) * m, level.sorted.data() + i * m);
+    }
+    std::swap(level.points, level.sorted);
+    return size;
+  }
+
+  /**
+   * @brief Drop the weakly dominated points of the set of a depth, already sorted by
+   *        decreasing first objective (the order is kept). A point can only be weakly
+   *        dominated by the points preceding it, or dominate the ones tied with it in the
+   *        first objective.
+   *
+   * @param depth The depth of the set.
+   * @param n The number of points of the set.
+   * @param m The number of objectives of the set.
+   * @return std::size_t The number of non dominated points (in place of the set).
+   */
+  std::size_t m_non_dominated(std::size_t const depth, std::size_t const n,
+                              std::size_t const m) {
+    auto* points = m_levels[depth].points.data();
+    std::size_t size = 0;
+    // the first kept point tied with the last one in the first objective
+    std::size_t tied = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      auto const* p = points + i * m;
+      if (size != 0 && points[(size - 1) * m] != p[0]) {
+        tied = size;
+      }
+
+      bool dominated = false;
+      for (std::size_t j = size; j-- > 0 && !dominated;) {
+        dominated = m_weakly_dominates(points + j * m + 1, p + 1, m - 1);
+      }
+      if (dominated) {
+        continue;
+      }
+
+      auto kept = tied;
+      for (std::size_t j = tied; j < size; ++j) {
+        auto const* q = points + j * m;
+        if (!m_weakly_dominates(p + 1, q + 1, m - 1)) {
+          std::copy(q, q + m, points + kept++ * m);
+        }
+      }
+      std::copy(p, p + m, points + kept * m);
+      size = kept + 1;
+    }
+    return size;
+  }
+
+  /// Hypervolume of the (sorted non dominated) set of a depth
+  hv_type m_hv(std::size_t const depth, std::size_t const n, std::size_t const m,
+               hv_type const* r) {
+    APMNKL_PROFILE_MAX(wfg_depth, depth + 1);
+    auto const* points = m_levels[depth].points.data();
+    if (n == 0) {
+      return 0;
+    } else if (n == 1) {
+      return m_point_hv(points, r, m);
+    } else if (m == 2) {
+      hv_type v = 0;
+      hv_type r1 = r[1];
+      for (std::size_t i = 0; i < n; ++i) {
+        v += (points[2 * i + 1] - r1) * (points[2 * i] - r[0]);
+        r1 = points[2 * i + 1];
+      }
+      return v;
+    } else if (m == 3) {
+      return m_hv3d(points, n, r);
+    }
+
+    // slices by decreasing first objective: the contribution of every point (projected) to
+    // the projections of the points preceding it, times the height of its slice. The front of
+    // the projections is kept sorted by decreasing first objective, and so are the limited
+    // sets (the limit is monotone)
+    auto& level = m_levels[depth];
+    auto& next = m_levels[depth + 1];
+    auto const k = m - 1;
+    m_reserve(level.front, n * k);
+    hv_type v = 0;
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      auto const* p = level.points.data() + i * m + 1;
+      auto* front = level.front.data();
+
+      m_reserve(next.points, size * k);
+      auto* limited = next.points.data();
+      std::size_t count = 0;
+      bool dominated = false;
+      for (std::size_t j = 0; j < size && !dominated; ++j) {
+        auto const* q = front + j * k;
+        auto* row = limited + count * k;
+        dominated = true;
+        for (std::size_t l = 0; l < k; ++l) {
+          row[l] = std::min(q[l], p[l]);
+          dominated &= q[l] >= p[l];
+        }
+        count += m_has_volume(row, r + 1, k);
+      }
+      if (dominated) {
+        continue;
+      }
+
+      auto hvc = m_point_hv(p, r + 1, k);
+      if (count != 0) {
+        hvc -= m_hv(depth + 1, m_non_dominated(depth + 1, count, k), k, r + 1);
+      }
+      v += (p[-1] - r[0]) * hvc;
+
+      // the projection replaces the projections it weakly dominates (in sorted position)
+      std::size_t kept = 0;
+      std::size_t position = 0;
+      for (std::size_t j = 0; j < size; ++j) {
+        auto const* q = front + j * k;
+        if (!m_weakly_dominates(p, q, k)) {
+          position += q[0] >= p[0];
+          std::copy(q, q + k, front + kept++ * k);
+        }
+      }
+      std::copy_backward(front + position * k, front + kept * k, front + (kept + 1) * k);
+      std::copy(p, p + k, front + position * k);
+      size = kept + 1;
+    }
+    return v;
+  }
+
+  /// 3d hypervolume of a (sorted non dominated) set: sweep by decreasing first objective
+  hv_type m_hv3d(hv_type const* points, std::size_t const n, hv_type const* r) {
+    using array2_t = std::array<hv_type, 2>;
+    m_sweep.clear();
+    m_sweep.push_back({r[1], std::numeric_limits<hv_type>::max()});
+    m_sweep.push_back({std::numeric_limits<hv_type>::max(), r[2]});
+
+    hv_type v = 0;
+    hv_type a = 0;
+    hv_type z = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      auto const* p = points + 3 * i;
+      v += a * (z - p[0]);
+      z = p[0];
+
+      auto tmp = array2_t{p[1], p[2]};
+      auto it = std::lower_bound(m_sweep.begin(), m_sweep.end(), tmp,
+                                 [](auto const& x, auto const& y) { return x[1] > y[1]; });
+      auto jt = it;
+
+      auto r0 = (*std::prev(it))[0];
+      auto r1 = tmp[1];
+      for (; (*it)[0] <= tmp[0]; ++it) {
+        a += (tmp[0] - r0) * (r1 - (*it)[1]);
+        r0 = (*it)[0];
+        r1 = (*it)[1];
+      }
+      a += (tmp[0] - r0) * (r1 - (*it)[1]);
+      if (jt != it) {
+        *jt = tmp;
+        m_sweep.erase(++jt, it);
+      } else {
+        m_sweep.insert(it, tmp);
+      }
+    }
+    return v + a * (z - r[0]);
+  }
+
+  std::size_t m_m;
+  std::vector<workspace> m_levels;
+  // the contributing point and the reference point, with the objectives reordered
+  std::vector<hv_type> m_point;
+  std::vector<hv_type> m_reference;
+  std::vector<std::size_t> m_order;
+  std::vector<std::size_t> m_clamped;
+  std::vector<hv_type> m_bound;
+  // the 2d front of the 3d sweep
+  std::vector<std::array<hv_type, 2>> m_sweep;
+};
+
 /**
  * @brief Compute a set hypervolume value given a reference point
  *        using the wfg algorithm. (Worker function)
@@ -125,11 +613,7 @@ template <typename S, typename T>
 std::common_type_t<typename S::value_type::value_type, typename T::value_type> set_hv_wfg(
     S const& s, T const& ref) {
   using result_t = std::common_type_t<typename S::value_type::value_type, typename T::value_type>;
-  auto res = result_t(0);
-  for (auto it = s.begin(); it != s.end(); ++it) {
-    res += point_hv(*it, ref) - set_hv_wfg(limit_set(std::next(it), s.end(), *it), ref);
-  }
-  return res;
+  return wfg<result_t>(ref.size()).set_hv(s, ref);
 }
 
 /**
@@ -145,13 +629,8 @@ std::common_type_t<typename S::value_type::value_type, typename T::value_type> s
  */
 template <typename S, typename T>
 auto set_hv(S const& s, T const& ref) {
-  std::vector<T> v;
-  v.reserve(s.size());
-  for (auto const& sol : s) {
-    v.push_back(sol.objective_vector());
-  }
-  sort(v.begin(), v.end(), [](auto const& a, auto const& b) { return a[0] < b[0]; });
-  return set_hv_wfg(v, ref);
+  return wfg<typename T::value_type>(ref.size()).set_hv(
+      s, ref, [](auto const& sol) -> auto const& { return sol.objective_vector(); });
 }
 
 /**
@@ -167,17 +646,122 @@ auto set_hv(S const& s, T const& ref) {
  */
 template <typename T, typename S, typename R>
 auto point_hvc(T const& p, S const& s, R const& ref) {
-  std::vector<T> v;
-  v.reserve(s.size());
-  for (auto const& sol : s) {
-    v.push_back(sol.objective_vector());
-  }
-  sort(v.begin(), v.end(), [](auto const& a, auto const& b) { return a[0] < b[0]; });
-  return point_hv(p, ref) - set_hv_wfg(limit_set(v.begin(), v.end(), p), ref);
+  return wfg<typename R::value_type>(ref.size())
+      .contribution(p, s, ref, [](auto const& sol) -> auto const& {
+        return sol.objective_vector();
+      });
 }
 
+/// Bi-objective non dominated front (sorted by the first objective) supporting
+/// incremental hypervolume contributions in O(log n) (plus the removed points)
+template <typename T>
+class hvfront2d {
+ public:
+  using hv_type = T;
+
+  hvfront2d(hv_type r0, hv_type r1)
+      : m_front()
+      , m_r0(r0)
+      , m_r1(r1) {}
+
+  /// Get the contribution of a new point w.r.t. to the current front
+  [[nodiscard]] hv_type contribution(hv_type a, hv_type b) const {
+    return m_contribution(a, b, m_front.upper_bound(a));
+  }
+
+  /// Inserts a new point (if it contributes) and returns its contribution
+  hv_type insert(hv_type a, hv_type b) {
+    auto last = m_front.upper_bound(a);
+    auto hvc = m_contribution(a, b, last);
+    if (hvc != 0) {
+      auto first = last;
+      while (first != m_front.begin() && std::prev(first)->second <= b) {
+        --first;
+      }
+      m_front.erase(first, last);
+      m_front.emplace_hint(last, a, b);
+    }
+    return hvc;
+  }
+
+  /// Removes a point and returns its contribution (i.e. the lost hv) or -1.0 if no point was found
+  hv_type remove(hv_type a, hv_type b) {
+    auto it = m_front.find(a);
+    if (it == m_front.end() || it->second != b) {
+      return -1.0;
+    }
+    it = m_front.erase(it);
+    hv_type ytop = it == m_front.end() ? m_r1 : it->second;
+    hv_type xleft = it == m_front.begin() ? m_r0 : std::prev(it)->first;
+    return (a - xleft) * (b - ytop);
+  }
+
+  /// Removes every point
+  void clear() {
+    m_front.clear();
+  }
+
+  /// Save the points of the front into a checkpoint
+  void save(checkpoint_writer& writer) const {
+    writer.write_size(m_front.size());
+    for (auto const& [a, b] : m_front) {
+      writer.write(a);
+      writer.write(b);
+    }
+  }
+
+  /// Load the points of the front from a checkpoint (replacing the current ones)
+  void load(checkpoint_reader& reader) {
+    m_front.clear();
+    for (auto size = reader.read_length(2 * sizeof(hv_type)); size != 0; --size) {
+      hv_type a, b;
+      reader.read(a);
+      reader.read(b);
+      m_front.emplace_hint(m_front.end(), a, b);
+    }
+  }
+
+ private:
+  /// Contribution of (a, b), last being the first point whose first objective is greater than a
+  hv_type m_contribution(hv_type a, hv_type b,
+                         typename std::map<hv_type, hv_type>::const_iterator last) const {
+    hv_type ytop = m_r1;
+    if (last != m_front.end()) {
+      if (last->second >= b) {
+        return 0;
+      }
+      ytop = last->second;
+    }
+
+    // staircase of the points dominated by (a, b) above ytop
+    hv_type xleft = m_r0;
+    hv_type covered = 0;
+    hv_type px = a;
+    hv_type ph = ytop;
+    for (auto it = last; it != m_front.begin();) {
+      --it;
+      if (it->second > b) {
+        xleft = it->first;
+        break;
+      }
+      covered += (px - it->first) * (ph - ytop);
+      px = it->first;
+      ph = it->second;
+    }
+    covered += (px - xleft) * (ph - ytop);
+
+    return (a - xleft) * (b - ytop) - covered;
+  }
+
+  std::map<hv_type, hv_type> m_front;
+  hv_type m_r0;
+  hv_type m_r1;
+};
+
 /// Implementation of an API that supports among others, set/point hypervolume calculations (using
-/// the WFG algorithm)
+/// a balanced-tree front for 2 objectives, a dimension sweep for 3 objectives and the WFG
+/// algorithm otherwise), or estimated by Monte Carlo sampling when an approximation is given. The
+/// temporary sets of the WFG recursion live in the (reused) flat workspaces of a wfg engine.
 template <typename T>
 class [[nodiscard]] hvobj {
  public:
@@ -185,214 +769,243 @@ class [[nodiscard]] hvobj {
   using ovec_type = std::vector<hv_type>;
   using set_type = std::vector<ovec_type>;
 
-  constexpr explicit hvobj(ovec_type const& r)
+  explicit hvobj(ovec_type const& r)
+      : hvobj(r, hv_approximation()) {}
+
+  /**
+   * @brief Construct a new hvobj object, estimating the hypervolume by Monte Carlo sampling if
+   *        the approximation has samples (for any number of objectives).
+   *
+   * @param r The reference point.
+   * @param approximation The number of samples (0 for the exact hypervolume), the upper bound
+   *        of the objectives and the seed of the samples.
+   */
+  hvobj(ovec_type const& r, hv_approximation const& approximation)
       : m_hv(0)
       , m_set()
-      , m_ref(r) {}
+      , m_ref(r)
+      , m_front(r.size() == 2 ? r[0] : 0, r.size() == 2 ? r[1] : 0)
+      , m_mc(r, approximation) {}
 
-  constexpr hvobj(hvobj const& other) = default;
-  constexpr hvobj(hvobj&& other) noexcept = default;
+  hvobj(hvobj const& other) = default;
+  hvobj(hvobj&& other) noexcept = default;
+  hvobj& operator=(hvobj const& other) = default;
+  hvobj& operator=(hvobj&& other) noexcept = default;
 
   /// Get the current hypervolume value
   [[nodiscard]] constexpr auto value() const {
     return m_hv;
   }
 
-  /// Get the contribution of a new vector w.r.t. to the current set
+  /// Get the reference point
+  [[nodiscard]] ovec_type const& reference() const {
+    return m_ref;
+  }
+
+  /// Get the approximation of the hypervolume (no samples if it is exact)
+  [[nodiscard]] hv_approximation const& approximation() const noexcept {
+    return m_mc.approximation();
+  }
+
+  /// Get the half-width of the 95% confidence interval of the value (0 if it is exact)
+  [[nodiscard]] hv_type confidence() const {
+    return m_mc.enabled() ? m_mc.confidence() : hv_type(0);
+  }
+
+  /// Get the contribution of a new vector w.r.t. to the current set (non-const, as it runs in
+  /// the workspaces of the object: an object is not to be shared by threads)
   template <typename V>
-  [[nodiscard]] constexpr auto contribution(V const& v) const {
-    return m_point_hv(v, m_ref) - m_set_hv(m_limit_set(m_set, v), m_ref);
+  [[nodiscard]] auto contribution(V const& v) {
+    APMNKL_PROFILE_SCOPE(hypervolume);
+    if (m_mc.enabled()) {
+      return m_mc.contribution(v);
+    } else if (m_ref.size() == 2) {
+      return m_front.contribution(v[0], v[1]);
+    } else if (m_ref.size() == 3) {
+      return m_contribution3d(v);
+    }
+    return m_wfg.contribution(v, m_set, m_ref);
   }
 
   /// Inserts a new objective vector and returns its contribution
   template <typename V>
-  constexpr auto insert(V&& v) {
+  auto insert(V&& v) {
+    APMNKL_PROFILE_SCOPE(hypervolume);
+    if (m_mc.enabled()) {
+      return m_insert_mc(std::forward<V>(v));
+    } else if (m_ref.size() == 2) {
+      auto hvc = m_front.insert(v[0], v[1]);
+      m_hv += hvc;
+      return hvc;
+    }
+
     auto hvc = contribution(v);
     if (hvc != 0) {
-      m_insert_non_dominated(std::forward<V>(v), m_set);
+      if (m_ref.size() == 3) {
+        m_insert3d(m_point(std::forward<V>(v)));
+      } else {
+        m_set.erase(std::remove_if(m_set.begin(), m_set.end(),
+                                   [&v](auto const& q) { return weakly_dominates(v, q); }),
+                    m_set.end());
+        m_set.push_back(m_point(std::forward<V>(v)));
+      }
       m_hv += hvc;
     }
     return hvc;
   }
 
   /// Removes a objective vector and returns its contribution (i.e. the lost hv) or -1.0 if no
-  /// objective vector was found.
+  /// objective vector was found. The Monte Carlo estimate keeps its set for every number of
+  /// objectives, so the exact front of two objectives is only used without it.
   template <typename V>
-  constexpr auto remove(V const& v) {
-    auto it = std::find(m_set.begin(), m_set.end(), v);
+  auto remove(V const& v) {
+    APMNKL_PROFILE_SCOPE(hypervolume);
+    if (!m_mc.enabled() && m_ref.size() == 2) {
+      auto hvc = m_front.remove(v[0], v[1]);
+      if (hvc != -1.0) {
+        m_hv -= hvc;
+      }
+      return hvc;
+    }
+
+    auto it = std::find_if(m_set.begin(), m_set.end(), [&v](auto const& q) {
+      return std::equal(q.begin(), q.end(), v.begin(), v.end());
+    });
     if (it == m_set.end())
       return -1.0;
     m_set.erase(it);
+    if (m_mc.enabled()) {
+      auto hvc = m_mc.remove(v, m_set);
+      m_hv = m_mc.value();
+      return hvc;
+    }
     auto hvc = contribution(v);
     m_hv -= hvc;
     return hvc;
   }
 
- private:
-  /// Check if a[1..] >= b[1..]
-  template <typename V>
-  [[nodiscard]] constexpr auto m_weakly_dominates(V const& a, V const& b) const {
-    for (size_t i = 1; i < a.size(); ++i) {
-      if (a[i] < b[i]) {
-        return false;
-      }
-    }
-    return true;
+  /// Save the state (reference point, approximation, value and set) into a checkpoint
+  void save(checkpoint_writer& writer) const {
+    auto const& approximation = m_mc.approximation();
+    writer.write(m_ref);
+    writer.write(std::make_tuple(approximation.samples, approximation.upper, approximation.seed));
+    writer.write(m_hv);
+    writer.write(m_set);
+    m_front.save(writer);
   }
 
-  /// insert non dominated point into a set implementation
-  template <typename V, typename C>
-  void m_insert_non_dominated(V&& v, C& set) const {
-    auto it = set.begin();
-
-    for (; it != set.end() && (*it)[0] > v[0]; ++it) {
-      if (m_weakly_dominates(*it, v)) {
-        return;
-      }
+  /// Load the state from a checkpoint, restoring the set in the very same order (and the
+  /// samples it dominates, which do not depend on the order of the insertions)
+  void load(checkpoint_reader& reader) {
+    ovec_type ref;
+    hv_approximation approximation;
+    reader.read(ref);
+    auto tuple = std::tie(approximation.samples, approximation.upper, approximation.seed);
+    reader.read(tuple);
+    // the samples are drawn (not read), so their number is only bounded by their 32-bit indices
+    if (approximation.samples > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error("corrupted checkpoint (invalid hypervolume approximation)");
     }
-
-    for (; it != set.end() && (*it)[0] == v[0]; ++it) {
-      if (m_weakly_dominates(*it, v)) {
-        return;
-      } else if (m_weakly_dominates(v, *it)) {
-        *it = std::forward<V>(v);
-        set.erase(std::remove_if(std::next(it), set.end(),
-                                 [this, it](auto const& a) { return m_weakly_dominates(*it, a); }),
-                  set.end());
-        return;
-      }
+    try {
+      *this = hvobj(ref, approximation);
+    } catch (std::invalid_argument const&) {
+      throw std::runtime_error("corrupted checkpoint (invalid hypervolume approximation)");
     }
-
-    if (it == set.end()) {
-      set.push_back(std::forward<V>(v));
-    } else {
-      auto aux = std::forward<V>(v);
-      std::swap(aux, *it);
-      for (auto jt = std::next(it); jt != set.end(); ++jt) {
-        if (m_weakly_dominates(*it, aux)) {
-          set.erase(
-              std::remove_if(jt, set.end(),
-                             [this, it](auto const& a) { return m_weakly_dominates(*it, a); }),
-              set.end());
-          return;
-        } else {
-          std::swap(aux, *jt);
-        }
-      }
-      if (!m_weakly_dominates(*it, aux)) {
-        set.push_back(std::move(aux));
+    reader.read(m_hv);
+    for (auto size = reader.read_length(sizeof(std::uint64_t)); size != 0; --size) {
+      ovec_type point;
+      reader.read(point);
+      if (m_mc.enabled()) {
+        m_mc.insert(point);
       }
+      m_set.push_back(std::move(point));
     }
+    m_front.load(reader);
   }
 
-  // limit_set (implementation)
-  template <typename S, typename V>
-  auto m_limit_set(S const& s, V const& v) const {
-    S res;
-    res.reserve(s.size());
-    for (auto const& p : s) {
-      auto aux = p;
-      for (size_t i = 0; i < aux.size(); ++i) {
-        aux[i] = std::min(aux[i], v[i]);
-      }
-      m_insert_non_dominated(std::move(aux), res);
+ private:
+  /// Convert a vector to a point of the set (moving it if it already is one)
+  template <typename V>
+  ovec_type m_point(V&& v) const {
+    if constexpr (std::is_same_v<std::decay_t<V>, ovec_type>) {
+      return std::forward<V>(v);
+    } else {
+      return ovec_type(v.begin(), v.end());
     }
-    return res;
   }
 
-  /// hypervolume of a point (implementation)
-  template <typename V, typename R>
-  auto m_point_hv(V const& v, R const& r) const {
-    auto res = v[0] - r[0];
-    for (size_t i = 1; i < v.size(); ++i) {
-      res *= v[i] - r[i];
+  /// insert a vector into the (unsorted) non dominated set of the Monte Carlo estimate
+  template <typename V>
+  hv_type m_insert_mc(V&& v) {
+    if (std::any_of(m_set.begin(), m_set.end(),
+                    [&v](auto const& q) { return weakly_dominates(q, v); })) {
+      return 0;
     }
-    return res;
+    auto hvc = m_mc.insert(v);
+    m_set.erase(std::remove_if(m_set.begin(), m_set.end(),
+                               [&v](auto const& q) { return weakly_dominates(v, q); }),
+                m_set.end());
+    m_set.push_back(m_point(std::forward<V>(v)));
+    m_hv = m_mc.value();
+    return hvc;
   }
 
-  /// 3d hypervolume of a set (implementation)
-  template <typename S, typename R>
-  auto m_set_hv3d(S const& s, R const& r) const {
-    using array2_t = std::array<hv_type, 2>;
-
-    auto aux = std::vector<array2_t>{{r[1], std::numeric_limits<hv_type>::max()},
-                                     {std::numeric_limits<hv_type>::max(), r[2]}};
-
-    hv_type v = 0;
-    hv_type a = 0;
-    hv_type z = 0;
+  /**
+   * 3d contribution of a vector (implementation): sweep the set by decreasing
+   * third objective, maintaining the 2d front of the (limited) points above
+   * the current height, and accumulate the area of the vector left uncovered
+   */
+  template <typename V>
+  auto m_contribution3d(V const& v) -> hv_type {
+    m_slice.clear();
 
-    for (auto const& p : s) {
-      v += a * (z - p[0]);
-      z = p[0];
+    hv_type area = (v[0] - m_ref[0]) * (v[1] - m_ref[1]);
+    hv_type volume = 0;
+    hv_type z = v[2];
 
-      auto tmp = array2_t{p[1], p[2]};
-      auto it = std::lower_bound(aux.begin(), aux.end(), tmp,
-                                 [](auto const& x, auto const& y) { return x[1] > y[1]; });
-      auto jt = it;
-
-      auto r0 = (*std::prev(it))[0];
-      auto r1 = tmp[1];
-      for (; (*it)[0] <= tmp[0]; ++it) {
-        a += (tmp[0] - r0) * (r1 - (*it)[1]);
-        r0 = (*it)[0];
-        r1 = (*it)[1];
-      }
-      a += (tmp[0] - r0) * (r1 - (*it)[1]);
-      if (jt != it) {
-        *jt = tmp;
-        aux.erase(++jt, it);
+    for (auto const& q : m_set) {
+      if (q[2] >= v[2]) {
+        if (q[0] >= v[0] && q[1] >= v[1]) {
+          return 0;
+        }
       } else {
-        aux.insert(it, tmp);
-      }
-    }
-    v += a * (z - r[0]);
-    return v;
-  }
-
-  /// Assumes set is sorted by increasing i
-  template <typename S, typename R>
-  auto m_set_hv(S const& s, R const& r, hv_type c = 1) const -> hv_type {
-    hv_type v = 0;
-
-    if (s.size() == 0) {
-      return 0;
-    }
-
-    if (s.begin()->size() == 2) {
-      hv_type r1 = r[1];
-      for (auto const& p : s) {
-        v += (p[1] - r1) * (p[0] - r[0]);
-        r1 = p[1];
-      }
-      v *= c;
-    } else if (s.begin()->size() == 3) {
-      v = c * m_set_hv3d(s, r);
-    } else {
-      auto newr = std::vector<hv_type>();
-      for (size_t i = 1; i < r.size(); ++i) {
-        newr.push_back(r[i]);
-      }
-      auto newl = std::vector<std::vector<hv_type>>();
-      newl.reserve(s.size());
-      for (auto const& p : s) {
-        auto newc = c * (p[0] - r[0]);
-        auto newp = std::vector<hv_type>();
-        for (size_t i = 1; i < p.size(); ++i) {
-          newp.push_back(p[i]);
+        if (q[2] <= m_ref[2]) {
+          break;
         }
+        volume += area * (z - q[2]);
+        z = q[2];
+      }
 
-        v += newc * m_point_hv(newp, newr) - m_set_hv(m_limit_set(newl, newp), newr, newc);
-
-        m_insert_non_dominated(std::move(newp), newl);
+      area -= m_slice.insert(std::min(q[0], v[0]), std::min(q[1], v[1]));
+      if (area <= 0) {
+        return volume;
       }
     }
-    return v;
+    return volume + area * (z - m_ref[2]);
+  }
+
+  /// insert a non dominated vector into the 3d set, sorted by decreasing third objective
+  template <typename V>
+  void m_insert3d(V&& v) {
+    m_set.erase(std::remove_if(m_set.begin(), m_set.end(),
+                               [&v](auto const& q) { return weakly_dominates(v, q); }),
+                m_set.end());
+    auto it = std::upper_bound(m_set.begin(), m_set.end(), v,
+                               [](auto const& a, auto const& b) { return a[2] > b[2]; });
+    m_set.insert(it, std::forward<V>(v));
   }
 
   hv_type m_hv;
+  // the non dominated vectors (sorted by decreasing third objective for 3
+  // objectives); unused for 2 objectives, unless estimated
   set_type m_set;
   ovec_type m_ref;
+  hvfront2d<hv_type> m_front;
+  hvfront2d<hv_type> m_slice{m_ref.size() == 3 ? m_ref[0] : 0, m_ref.size() == 3 ? m_ref[1] : 0};
+  // workspaces of the WFG recursion (unused for 2 and 3 objectives)
+  wfg<hv_type> m_wfg{m_ref.size()};
+  // samples of the Monte Carlo estimate (none if the hypervolume is exact)
+  hvmc<hv_type> m_mc;
 };
 
 }  // namespace priv